@@ -0,0 +1,85 @@
+/**
+ * @file bmp280_batch.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Host benchmark: bmp280_compensate_batch() against the per-sample compensation, in samples per second
+ */
+
+#include <bmp280.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SAMPLES     (1 << 20)
+#define ROUNDS      (8)
+
+// Datasheet's example, section 3.12
+static const struct bmp280_calib_t calib = {
+    .dig_T1 = 27504, .dig_T2 = 26435, .dig_T3 = -1000,
+    .dig_P1 = 36477, .dig_P2 = -10685, .dig_P3 = 3024, .dig_P4 = 2855, .dig_P5 = 140,
+    .dig_P6 = -7, .dig_P7 = 15500, .dig_P8 = -14600, .dig_P9 = 6000,
+};
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void) {
+    int32_t *raw_t = malloc(SAMPLES * sizeof(*raw_t));
+    int32_t *raw_p = malloc(SAMPLES * sizeof(*raw_p));
+    float *temp = malloc(SAMPLES * sizeof(*temp)), *press = malloc(SAMPLES * sizeof(*press));
+    float *ref_temp = malloc(SAMPLES * sizeof(*ref_temp)), *ref_press = malloc(SAMPLES * sizeof(*ref_press));
+    struct bmp280_t bmp280 = {.calib = calib};
+    double t0, scalar = 1e9, batch = 1e9;
+
+    srand(1);
+    for (size_t i = 0; i < SAMPLES; i++) {  // Around 25 degC and 1000 hPa
+        raw_t[i] = 519888 + rand() % 40000 - 20000;
+        raw_p[i] = 415148 + rand() % 40000 - 20000;
+    }
+
+    for (int r = 0; r < ROUNDS; r++) {  // Best of ROUNDS
+        t0 = now();
+        for (size_t i = 0; i < SAMPLES; i++) {
+            ref_temp[i] = bmp280_compensate_temp(&bmp280, raw_t[i]);
+            ref_press[i] = bmp280_compensate_press(&bmp280, raw_p[i]);
+        }
+        t0 = now() - t0;
+        scalar = t0 < scalar ? t0 : scalar;
+
+        t0 = now();
+        bmp280_compensate_batch(&calib, raw_t, raw_p, temp, press, SAMPLES);
+        t0 = now() - t0;
+        batch = t0 < batch ? t0 : batch;
+    }
+
+    if (memcmp(temp, ref_temp, SAMPLES * sizeof(*temp)) || memcmp(press, ref_press, SAMPLES * sizeof(*press))) {
+        printf("batch results differ from the scalar ones\n");
+        return 1;
+    }
+
+    printf("scalar: %.1f Msamples/s\n", SAMPLES / scalar / 1e6);
+    printf("batch: %.1f Msamples/s (x%.2f)\n", SAMPLES / batch / 1e6, scalar / batch);
+
+    scalar = batch = 1e9;
+    for (int r = 0; r < ROUNDS; r++) {  // Temperature only: the vectorized part
+        t0 = now();
+        for (size_t i = 0; i < SAMPLES; i++)
+            ref_temp[i] = bmp280_compensate_temp(&bmp280, raw_t[i]);
+        t0 = now() - t0;
+        scalar = t0 < scalar ? t0 : scalar;
+
+        t0 = now();
+        bmp280_compensate_batch(&calib, raw_t, NULL, temp, NULL, SAMPLES);
+        t0 = now() - t0;
+        batch = t0 < batch ? t0 : batch;
+    }
+    printf("scalar temperature: %.1f Msamples/s\n", SAMPLES / scalar / 1e6);
+    printf("batch temperature: %.1f Msamples/s (x%.2f)\n", SAMPLES / batch / 1e6, scalar / batch);
+
+    free(raw_t), free(raw_p), free(temp), free(press), free(ref_temp), free(ref_press);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file bmp280_fixed.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Cycles per sample of the BMP280 compensation: float/64-bit and fixed-point.
+ *  Runs on the host (main) and on target (app_main), where soft-float and 64-bit division matter most
+ */
+
+#include <bmp280.h>
+#include <stdio.h>
+
+#ifdef ESP_PLATFORM
+#include <xtensa/hal.h>
+#define cycles()    ((uint32_t) xthal_get_ccount())
+#define SAMPLES     (4096)
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define cycles()    ((uint32_t) __rdtsc())  // Reference cycles
+#define SAMPLES     (1 << 16)
+#else
+#include <time.h>
+static uint32_t cycles(void) {  // Nanoseconds instead
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) (ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+#define SAMPLES     (1 << 16)
+#endif
+
+#define ROUNDS      (8)
+
+// Datasheet's example, section 3.12
+static const struct bmp280_calib_t calib = {
+    .dig_T1 = 27504, .dig_T2 = 26435, .dig_T3 = -1000,
+    .dig_P1 = 36477, .dig_P2 = -10685, .dig_P3 = 3024, .dig_P4 = 2855, .dig_P5 = 140,
+    .dig_P6 = -7, .dig_P7 = 15500, .dig_P8 = -14600, .dig_P9 = 6000,
+};
+
+static struct bmp280_raw_t raw[SAMPLES];
+static volatile float sink_f;
+static volatile uint32_t sink_u;
+
+static uint32_t run_float(struct bmp280_t *bmp) {
+    float acc = 0;
+    uint32_t t0 = cycles();
+    for (int i = 0; i < SAMPLES; i++) {
+        acc += bmp280_compensate_temp(bmp, raw[i].temp);
+        acc += bmp280_compensate_press(bmp, raw[i].press);
+    }
+    t0 = cycles() - t0;
+    sink_f = acc;
+    return t0;
+}
+
+static uint32_t run_fixed(struct bmp280_t *bmp) {
+    uint32_t acc = 0;
+    uint32_t t0 = cycles();
+    for (int i = 0; i < SAMPLES; i++) {
+        acc += bmp280_compensate_temp_fixed(bmp, raw[i].temp);
+        acc += bmp280_compensate_press_fixed(bmp, raw[i].press);
+    }
+    t0 = cycles() - t0;
+    sink_u = acc;
+    return t0;
+}
+
+static uint32_t best(uint32_t (*run)(struct bmp280_t *), struct bmp280_t *bmp) {
+    uint32_t min = UINT32_MAX;
+    for (int r = 0; r < ROUNDS; r++) {
+        uint32_t t = run(bmp);
+        min = t < min ? t : min;
+    }
+    return min;
+}
+
+static int bench(void) {
+    struct bmp280_t bmp280 = {.calib = calib};
+    uint32_t seed = 1;
+
+    for (int i = 0; i < SAMPLES; i++) {  // Around 25 degC and 1000 hPa
+        seed = seed * 1103515245 + 12345;
+        raw[i].temp = 519888 + (int32_t) (seed >> 16) % 40000 - 20000;
+        seed = seed * 1103515245 + 12345;
+        raw[i].press = 415148 + (int32_t) (seed >> 16) % 40000 - 20000;
+    }
+
+    // Datasheet's example: 25.08 degC, 100653 Pa with the 64-bit formula, 100656 Pa with the 32-bit one
+    int32_t centi = bmp280_compensate_temp_fixed(&bmp280, 519888);
+    uint32_t pa = bmp280_compensate_press_fixed(&bmp280, 415148);
+    if (centi != 2508 || pa != 100656) {
+        printf("fixed-point compensation: %d %u, expected 2508 100656\n", (int) centi, (unsigned) pa);
+        return 1;
+    }
+
+    float max_err = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        bmp280_compensate_temp(&bmp280, raw[i].temp);
+        float err = bmp280_compensate_press(&bmp280, raw[i].press) * 100 - bmp280_compensate_press_fixed(&bmp280, raw[i].press);
+        err = err < 0 ? -err : err;
+        max_err = err > max_err ? err : max_err;
+    }
+    printf("fixed-point pressure: max %.0f Pa from the 64-bit formula\n", (double) max_err);
+
+    uint32_t c_float = best(run_float, &bmp280);
+    uint32_t c_fixed = best(run_fixed, &bmp280);
+
+    printf("float/64-bit: %.1f cycles/sample\n", (double) c_float / SAMPLES);
+    printf("fixed-point: %.1f cycles/sample\n", (double) c_fixed / SAMPLES);
+    return 0;
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void) {
+    bench();
+}
+#else
+int main(void) {
+    return bench();
+}
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file i2c_replay.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Host tool: replay a bus trace (see i2c_trace.h) against the device models on the simulated bus, at the
+ *  original pace or as fast as possible. Results and read data are compared with the recorded ones
+ *
+ *  i2c_replay [-f] [-n loops] [-w out.bin] [trace.bin]
+ *  -f  don't wait between transactions
+ *  -n  replay the trace loops times
+ *  -w  save the trace being replayed, e.g. the built-in one
+ *  Without a trace file, a BMP280 + SSD1306 session is captured on the simulated bus first
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_trace.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <ssd1306_fb.h>
+#include <ssd1306_sim.h>
+#include <ssd1306_text.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TRACE_RING      (1 << 16)
+#define CAPTURE_READS   (50)
+
+struct models_t {
+    struct bmp280_sim_t bmp280;
+    struct ssd1306_sim_t ssd1306;
+};
+
+static struct models_t models[I2C_NUM_MAX];
+static u8 ring_buf[TRACE_RING];
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Fresh models on both ports
+static void bus_up(void) {
+    i2c_deinit();
+    for (int port = 0; port < I2C_NUM_MAX; port++) {
+        struct i2c_bus_t conf = init_i2c_bus_default_master();
+        conf.port = (i2c_port_t) port;
+        i2c_sim_detach(conf.port, &models[port].bmp280.regs.dev);
+        i2c_sim_detach(conf.port, &models[port].ssd1306.dev);
+        i2c_sim_reset_stats(conf.port);
+        i2c_sim_attach(conf.port, bmp280_sim_init(&models[port].bmp280, BMP280_ADDR_PRIMARY));
+        i2c_sim_attach(conf.port, ssd1306_sim_init(&models[port].ssd1306, SSD1306_FB_ADDR));
+        i2c_init(&conf);
+    }
+}
+
+// Built-in session: sensor setup and readout, display setup and a few text updates
+static size_t capture(u8 **out) {
+    static struct ssd1306_t disp;
+    struct ssd1306_text_t text;
+    struct bmp280_t bmp280;
+    struct i2c_trace_t trace;
+    char line[16];
+    float temp, press;
+
+    bus_up();
+    i2c_trace_init(&trace, ring_buf, sizeof(ring_buf));
+    i2c_trace_start(PORT_1, &trace);
+    if (bmp280_init(&bmp280, PORT_1, BMP280_ADDR_PRIMARY) != ESP_OK || ssd1306_fb_init(&disp, PORT_1, SSD1306_FB_ADDR) != ESP_OK)
+        return 0;
+    bmp280_set_ctrl_meas(&bmp280, BMP280_CTRL_MEAS(BMP280_OSRS_X16, BMP280_OSRS_X16, BMP280_MODE_NORMAL));
+    ssd1306_text_init(&text, &disp, 0, 0, 10, 2);
+    for (int i = 0; i < CAPTURE_READS; i++) {
+        bmp280_read(&bmp280, &temp, &press);
+        snprintf(line, sizeof(line), "%.1f" SSD1306_DEGREE, temp + i / 10.0f);
+        ssd1306_text_set(&text, line);
+        ssd1306_fb_flush(&disp);
+        usleep(1000);
+    }
+    i2c_trace_stop(PORT_1);
+
+    size_t len = i2c_trace_dump_size(&trace);
+    *out = malloc(len);
+    return *out ? i2c_trace_dump(&trace, *out, len) : 0;
+}
+
+static size_t load(const char *path, u8 **out) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return 0;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    *out = len > 0 ? malloc(len) : NULL;
+    size_t ret = *out ? fread(*out, 1, len, f) : 0;
+    fclose(f);
+    return ret;
+}
+
+/**
+ * @struct replay_t
+ * @var replay_t::skipped
+ *  records of ports or segment counts this bus can't take
+ * @var replay_t::result_diff
+ *  transactions whose result differs from the recorded one
+ * @var replay_t::data_diff
+ *  successful reads whose data differs from the recorded one
+ * @var replay_t::truncated
+ *  writes longer than the captured payload, sent padded with zeros
+ */
+struct replay_t {
+    uint32_t transactions;
+    uint32_t skipped;
+    uint32_t result_diff;
+    uint32_t data_diff;
+    uint32_t truncated;
+    uint64_t bytes;
+};
+
+static void replay(const u8 *data, size_t len, bool fast, struct replay_t *r) {
+    static u8 scratch[I2C_TRACE_SEGS][UINT16_MAX];
+    struct i2c_trace_rec_t rec;
+    struct i2c_msg_t msgs[I2C_TRACE_SEGS];
+    size_t off = i2c_trace_first(data, len);
+    uint32_t ts0 = 0;
+    double t0 = now();
+
+    for (bool first = true; i2c_trace_next(data, len, &off, &rec); first = false) {
+        if (first)
+            ts0 = rec.ts_us;
+        if (rec.port >= I2C_NUM_MAX || !rec.n) {
+            r->skipped++;
+            continue;
+        }
+        if (!fast) {  // Wait for the recorded offset; uint32_t difference survives the timestamp wrap
+            double at = t0 + (uint32_t) (rec.ts_us - ts0) / 1e6, wait = at - now();
+            if (wait > 0)
+                usleep((useconds_t) (wait * 1e6));
+        }
+        for (size_t i = 0; i < rec.n; i++) {
+            struct i2c_trace_seg_t *seg = &rec.seg[i];
+            msgs[i] = (struct i2c_msg_t) {.buf = scratch[i], .len = seg->len, .flags = seg->flags};
+            if (!(seg->flags & I2C_MSG_READ)) {
+                memcpy(scratch[i], seg->data, seg->captured);
+                memset(scratch[i] + seg->captured, 0, seg->len - seg->captured);
+                r->truncated += seg->captured < seg->len;
+            }
+        }
+        struct i2c_dev_handle_t dev = {.port = rec.port, .addr = rec.addr};
+        esp_err_t ret = i2c_transfer(&dev, msgs, rec.n);
+        r->transactions++;
+        if (i2c_trace_err_result(ret) != rec.result) {
+            r->result_diff++;
+            continue;
+        }
+        for (size_t i = 0; i < rec.n; i++) {
+            if (ret == ESP_OK)
+                r->bytes += rec.seg[i].len;
+            if (ret == ESP_OK && (rec.seg[i].flags & I2C_MSG_READ) && memcmp(scratch[i], rec.seg[i].data, rec.seg[i].captured)) {
+                r->data_diff++;
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    bool fast = false;
+    int loops = 1, opt;
+    const char *save = NULL;
+    u8 *data = NULL;
+    size_t len;
+
+    while ((opt = getopt(argc, argv, "fn:w:")) != -1) {
+        switch (opt) {
+            case 'f':
+                fast = true;
+                break;
+            case 'n':
+                loops = atoi(optarg);
+                break;
+            case 'w':
+                save = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-f] [-n loops] [-w out.bin] [trace.bin]\n", argv[0]);
+                return 2;
+        }
+    }
+    len = optind < argc ? load(argv[optind], &data) : capture(&data);
+    if (!len || !i2c_trace_first(data, len)) {
+        fprintf(stderr, "no valid trace\n");
+        return 1;
+    }
+    if (save) {
+        FILE *f = fopen(save, "wb");
+        if (!f || fwrite(data, 1, len, f) != len)
+            perror(save);
+        if (f)
+            fclose(f);
+    }
+
+    struct replay_t r = {0};
+    struct i2c_sim_stats_t sim;
+    uint64_t bus_ns = 0;
+    bus_up();
+    double t0 = now();
+    for (int i = 0; i < loops; i++)
+        replay(data, len, fast, &r);
+    double elapsed = now() - t0;
+    for (int port = 0; port < I2C_NUM_MAX; port++) {
+        i2c_sim_get_stats((i2c_port_t) port, &sim);
+        bus_ns += sim.bus_time_ns;
+    }
+
+    printf("trace: %zu bytes, replayed %d time(s)%s\n", len, loops, fast ? " at full speed" : "");
+    printf("transactions: %u, skipped: %u, result mismatches: %u, data mismatches: %u, truncated writes: %u\n",
+        r.transactions, r.skipped, r.result_diff, r.data_diff, r.truncated);
+    printf("elapsed: %.3f s, %.0f transactions/s, %.0f bytes/s, simulated bus time: %.3f s\n",
+        elapsed, r.transactions / elapsed, r.bytes / elapsed, bus_ns / 1e9);
+    i2c_deinit();
+    free(data);
+    return r.result_diff || r.data_diff ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+/**
+ * @file libi2c_bench.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Per-call cost of the libi2c hot paths on the simulated bus, plus compensation and display flush.
+ *  Prints CSV on stdout, one row per case, to be diffed across versions:
+ *  name,iterations,ns_per_op,items_per_op,ns_per_item,bus_bytes_per_op
+ *  ns_per_op is the best of BENCH_ROUNDS runs. bus_bytes_per_op counts what the simulated bus carried, address bytes
+ *  included, so it catches regressions that add traffic rather than CPU time.
+ *  Runs on the host (main, optional name filter as argument) and on target (app_main), where it also times the
+ *  ESP-IDF command link
+ */
+
+#include <libi2c.h>
+#include <i2c_backend.h>
+#include <i2c_sim.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <ssd1306_fb.h>
+#include <ssd1306_sim.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_timer.h>
+#define now_ns()    ((uint64_t) esp_timer_get_time() * 1000)
+#define BENCH_SCALE (16)  // Iterations divider
+#else
+#include <time.h>
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+#define BENCH_SCALE (1)
+#endif
+
+#define BENCH_FORMAT    (1)  // Bump when columns change
+#define BENCH_ROUNDS    (5)
+#define BATCH_SAMPLES   (1024)
+
+/**
+ * @struct bench_case_t
+ * @var bench_case_t::setup
+ *  run once before timing, can be NULL
+ * @var bench_case_t::op
+ *  the timed operation
+ * @var bench_case_t::items
+ *  work items per operation, e.g. samples of a batch
+ */
+struct bench_case_t {
+    const char *name;
+    void (*setup)(void);
+    void (*op)(void);
+    uint32_t iters;
+    uint32_t items;
+};
+
+static struct bmp280_sim_t fake_bmp280;
+static struct ssd1306_sim_t fake_ssd1306;
+static struct bmp280_t bmp280;
+static struct ssd1306_t disp;
+static struct i2c_dev_handle_t dev = {.port = PORT_1, .addr = BMP280_ADDR_PRIMARY};
+static u8 buf[8];
+static int32_t raw_t[BATCH_SAMPLES], raw_p[BATCH_SAMPLES];
+static float temp[BATCH_SAMPLES], press[BATCH_SAMPLES];
+static unsigned frame;
+
+static void op_read_bytes_1(void) {
+    i2c_read_bytes(&dev, buf, 1);
+}
+
+static void op_read_bytes_6(void) {
+    i2c_read_bytes(&dev, buf, 6);
+}
+
+static void op_write_bytes_2(void) {
+    static const u8 data[2] = {BMP280_REG_CONFIG, 0x00};
+    i2c_write_bytes(&dev, data, sizeof(data));
+}
+
+static void op_select_read_6(void) {
+    i2c_select_register(&dev, BMP280_REG_DATA, READ_BIT);
+    i2c_read_bytes(&dev, buf, 6);
+}
+
+static void op_read_register_6(void) {
+    i2c_read_register(&dev, BMP280_REG_DATA, buf, 6);
+}
+
+static void op_backend_6(void) {  // Baseline: the backend alone, no locking or bookkeeping
+    u8 reg = BMP280_REG_DATA;
+    struct i2c_msg_t msgs[2] = {
+        {.buf = &reg, .len = 1, .flags = I2C_MSG_WRITE},
+        {.buf = buf, .len = 6, .flags = I2C_MSG_READ},
+    };
+    i2c_backend_sim.transfer(dev.port, dev.addr, msgs, 2, I2C_DEFAULT_TIMEOUT_MS);
+}
+
+static void op_bmp280_read(void) {
+    float t, p;
+    bmp280_read(&bmp280, &t, &p);
+}
+
+static void setup_batch(void) {
+    uint32_t seed = 1;
+    for (int i = 0; i < BATCH_SAMPLES; i++) {  // Around 25 degC and 1000 hPa
+        seed = seed * 1103515245 + 12345;
+        raw_t[i] = 519888 + (int32_t) (seed >> 16) % 40000 - 20000;
+        seed = seed * 1103515245 + 12345;
+        raw_p[i] = 415148 + (int32_t) (seed >> 16) % 40000 - 20000;
+    }
+}
+
+static void op_compensate(void) {
+    for (int i = 0; i < BATCH_SAMPLES; i++) {
+        temp[i] = bmp280_compensate_temp(&bmp280, raw_t[i]);
+        press[i] = bmp280_compensate_press(&bmp280, raw_p[i]);
+    }
+}
+
+static void op_compensate_batch(void) {
+    bmp280_compensate_batch(&bmp280.calib, raw_t, raw_p, temp, press, BATCH_SAMPLES);
+}
+
+static void op_flush_clean(void) {
+    ssd1306_fb_flush(&disp);
+}
+
+static void op_flush_pixel(void) {
+    ssd1306_fb_pixel(&disp, 64, 32, ++frame & 1);
+    ssd1306_fb_flush(&disp);
+}
+
+static void op_flush_full(void) {
+    memset(disp.fb, ++frame & 1 ? 0xff : 0x00, sizeof(disp.fb));
+    for (u8 page = 0; page < SSD1306_FB_PAGES; page++)
+        ssd1306_fb_mark_dirty(&disp, page, 0, SSD1306_FB_WIDTH - 1);
+    ssd1306_fb_flush(&disp);
+}
+
+#ifdef ESP_PLATFORM
+static void build_link(i2c_cmd_handle_t cmd) {
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (dev.addr << 1) | READ_BIT, ACK_CHECK_EN);
+    i2c_master_read(cmd, buf, 6, I2C_MASTER_LAST_NACK);
+    i2c_master_stop(cmd);
+}
+
+static void op_cmd_link_heap(void) {
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    build_link(cmd);
+    i2c_cmd_link_delete(cmd);
+}
+
+static void op_cmd_link_static(void) {
+    static u8 storage[I2C_LINK_RECOMMENDED_SIZE(3)] __attribute__((aligned(4)));
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(storage, sizeof(storage));
+    build_link(cmd);
+    i2c_cmd_link_delete_static(cmd);
+}
+#endif
+
+static const struct bench_case_t cases[] = {
+    {"backend_sim_6", NULL, op_backend_6, 200000, 1},
+    {"read_bytes_1", NULL, op_read_bytes_1, 200000, 1},
+    {"read_bytes_6", NULL, op_read_bytes_6, 200000, 1},
+    {"write_bytes_2", NULL, op_write_bytes_2, 200000, 1},
+    {"select_read_6", NULL, op_select_read_6, 200000, 1},
+    {"read_register_6", NULL, op_read_register_6, 200000, 1},
+    {"bmp280_read", NULL, op_bmp280_read, 100000, 1},
+#ifdef ESP_PLATFORM
+    {"cmd_link_heap", NULL, op_cmd_link_heap, 100000, 1},
+    {"cmd_link_static", NULL, op_cmd_link_static, 100000, 1},
+#endif
+    {"compensate", setup_batch, op_compensate, 200, BATCH_SAMPLES},
+    {"compensate_batch", setup_batch, op_compensate_batch, 200, BATCH_SAMPLES},
+    {"flush_clean", NULL, op_flush_clean, 200000, 1},
+    {"flush_pixel", NULL, op_flush_pixel, 20000, 1},
+    {"flush_full", NULL, op_flush_full, 2000, 1},
+};
+
+static uint64_t bus_bytes(void) {
+    struct i2c_sim_stats_t stats;
+    i2c_sim_get_stats(dev.port, &stats);
+    return stats.bytes;
+}
+
+static void run(const struct bench_case_t *c) {
+    uint32_t iters = c->iters / BENCH_SCALE ? c->iters / BENCH_SCALE : 1;
+    uint64_t best = UINT64_MAX, bytes = 0;
+    if (c->setup)
+        c->setup();
+    c->op();  // Warm-up: caches, lazy state such as the display's first full frame
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint64_t b0 = bus_bytes(), t0 = now_ns();
+        for (uint32_t i = 0; i < iters; i++)
+            c->op();
+        t0 = now_ns() - t0;
+        best = t0 < best ? t0 : best;
+        bytes = bus_bytes() - b0;
+    }
+    double ns = (double) best / iters;
+    printf("%s,%u,%.1f,%u,%.2f,%.1f\n", c->name, (unsigned) iters, ns, (unsigned) c->items, ns / c->items,
+        (double) bytes / iters);
+}
+
+static int bench(const char *filter) {
+    struct i2c_bus_t conf = init_i2c_bus_default_master();
+    conf.backend = &i2c_backend_sim;
+    i2c_sim_attach(conf.port, bmp280_sim_init(&fake_bmp280, BMP280_ADDR_PRIMARY));
+    i2c_sim_attach(conf.port, ssd1306_sim_init(&fake_ssd1306, SSD1306_FB_ADDR));
+    i2c_init(&conf);
+    if (bmp280_init(&bmp280, conf.port, BMP280_ADDR_PRIMARY) != ESP_OK || ssd1306_fb_init(&disp, conf.port, SSD1306_FB_ADDR) != ESP_OK) {
+        printf("# device setup failed\n");
+        return 1;
+    }
+    bmp280_set_ctrl_meas(&bmp280, BMP280_CTRL_MEAS(BMP280_OSRS_X16, BMP280_OSRS_X16, BMP280_MODE_NORMAL));
+
+    printf("# libi2c bench, format %d, backend %s\n", BENCH_FORMAT, i2c_get_backend(conf.port)->name);
+    printf("name,iterations,ns_per_op,items_per_op,ns_per_item,bus_bytes_per_op\n");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (!filter || strstr(cases[i].name, filter))
+            run(&cases[i]);
+    }
+    i2c_deinit();
+    return 0;
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void) {
+    bench(NULL);
+}
+#else
+int main(int argc, char **argv) {
+    return bench(argc > 1 ? argv[1] : NULL);
+}
+#endif
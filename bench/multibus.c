@@ -0,0 +1,110 @@
+/**
+ * @file multibus.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Host benchmark: two BMP280 read back-to-back through the port workers, sharing one port and then placed
+ *  on a port each. The simulated bus runs in real time, so the split shows how much the second controller buys
+ */
+
+#include <i2c_multibus.h>
+#include <i2c_sim.h>
+#include <bmp280_sim.h>
+#include <stdio.h>
+#include <time.h>
+
+#define READS       (500)  // Per sensor
+#define CLK_HZ      (400000)
+#define RATE        (1000)  // Bytes per second per sensor, for the placement
+
+struct sensor_t {
+    struct i2c_dev_handle_t dev;
+    struct i2c_xfer_t xfer;
+    u8 data[BMP280_DATA_LEN];
+    unsigned left;
+    unsigned failed;
+};
+
+static unsigned running;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void done(struct i2c_xfer_t *xfer, void *arg) {
+    struct sensor_t *s = arg;
+    if (xfer->result != ESP_OK)
+        s->failed++;
+    if (--s->left)
+        i2c_submit(xfer);
+    else
+        __atomic_fetch_sub(&running, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief place two sensors answering at addrs[i], read them READS times each, concurrently
+ * @return seconds, < 0 on error
+ */
+static double run(const char *name, const i2c_addr_t addrs[2]) {
+    struct i2c_bus_t confs[2] = {init_i2c_bus_default_master(), init_i2c_bus_default_master()};
+    confs[0].port = PORT_0;
+    confs[0].conf.master.clk_speed = confs[1].conf.master.clk_speed = CLK_HZ;
+    struct i2c_multibus_t mb;
+    struct sensor_t sensors[2] = {0};
+
+    if (i2c_multibus_init(&mb, confs, 2, true) != ESP_OK)
+        return -1;
+    for (int i = 0; i < 2; i++) {
+        if (i2c_multibus_place(&mb, &sensors[i].dev, addrs[i], RATE) != ESP_OK) {
+            i2c_multibus_deinit(&mb);
+            return -1;
+        }
+        sensors[i].left = READS;
+    }
+    i2c_sim_set_realtime(PORT_0, true);
+    i2c_sim_set_realtime(PORT_1, true);
+
+    double t0 = now();
+    running = 2;
+    for (int i = 0; i < 2; i++) {
+        i2c_xfer_read_register(&sensors[i].xfer, &sensors[i].dev, BMP280_REG_DATA, sensors[i].data, BMP280_DATA_LEN,
+            done, &sensors[i]);
+        i2c_submit(&sensors[i].xfer);
+    }
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        struct timespec ts = {.tv_nsec = 100000};
+        nanosleep(&ts, NULL);
+    }
+    t0 = now() - t0;
+
+    printf("%s: 0x%02x on port %d, 0x%02x on port %d, load %u/%u per mille, %.0f reads/s, %u failed\n", name,
+        sensors[0].dev.addr, sensors[0].dev.port, sensors[1].dev.addr, sensors[1].dev.port,
+        i2c_multibus_load(&mb, PORT_0), i2c_multibus_load(&mb, PORT_1), 2 * READS / t0,
+        sensors[0].failed + sensors[1].failed);
+    i2c_sim_set_realtime(PORT_0, false);
+    i2c_sim_set_realtime(PORT_1, false);
+    i2c_multibus_deinit(&mb);
+    return t0;
+}
+
+int main(void) {
+    struct bmp280_sim_t models[3];
+
+    // Both on PORT_1, primary and secondary address
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&models[0], BMP280_ADDR_PRIMARY));
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&models[1], BMP280_ADDR_SECONDARY));
+    double shared = run("shared", (const i2c_addr_t[]) {BMP280_ADDR_PRIMARY, BMP280_ADDR_SECONDARY});
+    i2c_sim_detach(PORT_1, &models[1].regs.dev);
+
+    // Same address on both ports: placement gives each one a port
+    i2c_sim_attach(PORT_0, bmp280_sim_init(&models[2], BMP280_ADDR_PRIMARY));
+    double split = run("split", (const i2c_addr_t[]) {BMP280_ADDR_PRIMARY, BMP280_ADDR_PRIMARY});
+
+    if (shared < 0 || split < 0) {
+        printf("placement failed\n");
+        return 1;
+    }
+    printf("speedup: x%.2f\n", shared / split);
+    return 0;
+}
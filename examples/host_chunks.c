@@ -0,0 +1,138 @@
+/**
+ * @file host_chunks.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: transfers longer than the adapter takes. The simulated bus is limited to a few bytes
+ *  per transaction; register reads and writes are split with the register address advancing on every chunk, and
+ *  i2c_write_stream sends its prefix with each chunk and refuses a producer that overfills its buffer. i2c_writev
+ *  can't split, so it refuses a payload that doesn't fit
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEV_ADDR        (0x50)
+#define MAX_TRANSFER    (16)
+#define REG_BLOCK       (0x10)
+#define REG_FIFO        (0x80)
+#define LEN             (40)
+#define STREAM_LEN      (50)
+#define LOG_LEN         (256)
+
+static struct i2c_sim_regs_t model;
+static u8 log_reg[LOG_LEN], log_data[LOG_LEN];
+static size_t logged;
+static int failed;
+
+// Every byte the model stores, with the register it went to
+static void on_write(struct i2c_sim_regs_t *m, u8 reg, u8 data) {
+    (void) m;
+    if (logged < LOG_LEN) {
+        log_reg[logged] = reg;
+        log_data[logged++] = data;
+    }
+}
+
+struct stream_t {
+    const u8 *data;
+    size_t len, pos, asked, extra;
+};
+
+static size_t produce(u8 *buf, size_t size, void *arg) {
+    struct stream_t *s = arg;
+    size_t n = s->len - s->pos < size ? s->len - s->pos : size;
+    s->asked = size;
+    memcpy(buf, s->data + s->pos, n);
+    s->pos += n;
+    return n ? n + s->extra : 0;  // extra: a buggy producer claiming more than it was given room for
+}
+
+static uint64_t transactions(void) {
+    struct i2c_sim_stats_t stats;
+    i2c_sim_get_stats(PORT_1, &stats);
+    return stats.transactions;
+}
+
+static void check(bool ok, const char *what, uint64_t bus) {
+    printf("%-52s %2llu transaction(s)  %s\n", what, (unsigned long long) bus, ok ? "ok" : "FAILED");
+    failed += !ok;
+}
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_sim_attach(PORT_1, i2c_sim_regs_init(&model, DEV_ADDR));
+    model.on_write = on_write;
+    i2c_sim_set_max_transfer(PORT_1, MAX_TRANSFER);
+    i2c_init(&master_config);
+
+    struct i2c_dev_handle_t dev = {.port = PORT_1, .addr = DEV_ADDR};
+    u8 data[STREAM_LEN], back[LEN];
+    for (int i = 0; i < STREAM_LEN; i++)
+        data[i] = (u8) (0xa0 + i);
+    uint64_t t;
+    bool ok;
+
+    u8 big[MAX_TRANSFER + 1];
+    struct i2c_msg_t msg = {.buf = big, .len = sizeof(big), .flags = I2C_MSG_READ};
+    t = transactions();
+    ok = i2c_transfer(&dev, &msg, 1) == ESP_ERR_INVALID_SIZE;
+    check(ok && transactions() == t, "one transaction over the limit is refused", transactions() - t);
+
+    // Gather writes aren't split: the payload must fit, only a 1-byte first segment is left out
+    const u8 reg = REG_BLOCK;
+    const struct i2c_iovec_t fits[] = {{.base = &reg, .len = 1}, {.base = data, .len = MAX_TRANSFER}};
+    const struct i2c_iovec_t too_long[] = {{.base = &reg, .len = 1}, {.base = data, .len = LEN}};
+    const struct i2c_iovec_t single[] = {{.base = data, .len = LEN}};
+    t = transactions();
+    ok = i2c_writev(&dev, fits, 2) == ESP_OK && i2c_writev(&dev, too_long, 2) == ESP_ERR_INVALID_SIZE
+        && i2c_writev(&dev, single, 1) == ESP_ERR_INVALID_SIZE;
+    check(ok && transactions() - t == 1, "gather write: fits, too long, one oversized segment", transactions() - t);
+
+    // Register write: chunk k goes to REG_BLOCK + k * MAX_TRANSFER
+    logged = 0;
+    t = transactions();
+    ok = i2c_write_register(&dev, REG_BLOCK, data, LEN) == ESP_OK && !memcmp(model.regs + REG_BLOCK, data, LEN);
+    t = transactions() - t;
+    for (size_t i = 0; i < logged; i++)
+        ok &= log_reg[i] == REG_BLOCK + i;
+    check(ok && logged == LEN && t == (LEN + MAX_TRANSFER - 1) / MAX_TRANSFER, "register write, split", t);
+
+    memcpy(model.regs + REG_BLOCK, data + 1, LEN);  // Changed behind its back: the read must go to the bus
+    t = transactions();
+    ok = i2c_read_register(&dev, REG_BLOCK, back, LEN) == ESP_OK && !memcmp(back, data + 1, LEN);
+    t = transactions() - t;
+    check(ok && t == (LEN + MAX_TRANSFER - 1) / MAX_TRANSFER, "register read, split", t);
+
+    // Stream: the prefix (FIFO register) opens every chunk, the payload comes out in order
+    struct stream_t stream = {.data = data, .len = STREAM_LEN};
+    const u8 fifo = REG_FIFO;
+    logged = 0;
+    t = transactions();
+    ok = i2c_write_stream(&dev, &fifo, 1, produce, &stream) == ESP_OK && stream.asked == MAX_TRANSFER;
+    t = transactions() - t;
+    ok &= logged == STREAM_LEN && !memcmp(log_data, data, STREAM_LEN);
+    for (size_t i = 0; i < logged; i++)
+        ok &= log_reg[i] == REG_FIFO + i % MAX_TRANSFER;
+    check(ok && t == (STREAM_LEN + MAX_TRANSFER - 1) / MAX_TRANSFER, "stream, 1-byte prefix", t);
+
+    // A 2-byte prefix takes one byte from each chunk
+    const u8 fifo_ch[2] = {REG_FIFO, 0x00};
+    stream.pos = 0;
+    t = transactions();
+    ok = i2c_write_stream(&dev, fifo_ch, sizeof(fifo_ch), produce, &stream) == ESP_OK && stream.asked == MAX_TRANSFER - 1;
+    t = transactions() - t;
+    check(ok && t == (STREAM_LEN + MAX_TRANSFER - 2) / (MAX_TRANSFER - 1), "stream, 2-byte prefix", t);
+
+    stream.pos = 0;
+    stream.extra = 1;
+    t = transactions();
+    ok = i2c_write_stream(&dev, &fifo, 1, produce, &stream) == ESP_ERR_INVALID_SIZE;
+    t = transactions() - t;
+    check(ok && t == 0, "stream, producer returning too much: refused", t);
+
+    i2c_deinit();
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
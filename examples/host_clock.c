@@ -0,0 +1,51 @@
+/**
+ * @file host_clock.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: adaptive bus clock on a simulated bus that gets flaky above 600 kHz. The tuner
+ *  climbs the ladder, backs off at 800 kHz, retries it after longer and longer holds and stays at 600 kHz
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_clock.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <stdio.h>
+
+#define CLK_LIMIT   (600000)
+#define READS       (200000)
+
+static struct bmp280_sim_t fake_bmp280;
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&fake_bmp280, BMP280_ADDR_PRIMARY));
+    i2c_sim_set_clock_limit(PORT_1, CLK_LIMIT);
+    i2c_init(&master_config);
+
+    struct i2c_clock_tuner_t tuner;
+    struct i2c_dev_handle_t dev = {.port = PORT_1, .addr = BMP280_ADDR_PRIMARY};
+    u8 data[BMP280_DATA_LEN];
+    if (i2c_clock_tuner_init(&tuner, PORT_1, I2C_CLOCK_MIN_HZ) != ESP_OK)
+        return 1;
+
+    uint32_t hz = tuner.hz, above = 0;
+    for (int i = 0; i < READS; i++) {
+        i2c_read_register(&dev, BMP280_REG_DATA, data, sizeof(data));
+        i2c_clock_tuner_step(&tuner);
+        if (tuner.hz != hz) {
+            printf("%6d: %4u kHz -> %4u kHz (hold %u windows)\n", i, (unsigned) (hz / 1000), (unsigned) (tuner.hz / 1000),
+                (unsigned) tuner.hold);
+            hz = tuner.hz;
+        }
+        above += tuner.hz > CLK_LIMIT;
+    }
+
+    bool ok = tuner.hz == CLK_LIMIT && tuner.hold > I2C_CLOCK_HOLD && above < READS / 20;
+    printf("Settled at %u kHz after %u ups and %u downs, %u%% of the reads above the limit\n", (unsigned) (tuner.hz / 1000),
+        (unsigned) tuner.ups, (unsigned) tuner.downs, (unsigned) (above * 100ULL / READS));
+    i2c_deinit();
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
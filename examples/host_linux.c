@@ -0,0 +1,86 @@
+/**
+ * @file host_linux.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host through the i2c-dev backend, with the ioctls executed on the simulated bus: a BMP280
+ *  readout on a plain I2C adapter (I2C_RDWR), on one without I2C_FUNC_NOSTART (register writes merged into a bounce
+ *  buffer) and on an SMBus-only one (same functionality as i2c-stub), counting the syscalls each register read
+ *  costs, and register reads and writes too long for a single i2c-dev message
+ */
+
+#include <libi2c.h>
+#include <i2c_linux.h>
+#include <i2c_sim.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <stdio.h>
+
+#define BIG_LEN     (10000)  // More than the 8192 bytes i2c-dev takes per I2C_RDWR message
+#define SCRATCH     (0x50)
+
+static struct bmp280_sim_t fake_bmp280;
+static struct i2c_sim_regs_t scratch;
+static u8 big[BIG_LEN];
+
+// BMP280 readout through an adapter with the given functionality. Returns the number of failed checks
+static int run(const char *name, unsigned long funcs) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    master_config.backend = &i2c_backend_linux;
+    i2c_linux_use_sim(master_config.port, funcs);
+    if (i2c_init(&master_config) != ESP_OK) {
+        printf("%s: init failed\n", name);
+        return 1;
+    }
+
+    struct bmp280_t bmp280;
+    float temp, press;
+    int failed = 0;
+    if (bmp280_init(&bmp280, master_config.port, BMP280_ADDR_PRIMARY) != ESP_OK || bmp280_read_calib(&bmp280) != ESP_OK) {
+        printf("%s: BMP280 not found\n", name);
+        i2c_deinit();
+        return 1;
+    }
+    bmp280_set_ctrl_meas(&bmp280, BMP280_CTRL_MEAS(BMP280_OSRS_X16, BMP280_OSRS_X16, BMP280_MODE_NORMAL));
+
+    uint64_t before = i2c_linux_ioctl_count(master_config.port);
+    esp_err_t ret = bmp280_read(&bmp280, &temp, &press);  // One register read: pointer write + 6-byte read
+    uint64_t ioctls = i2c_linux_ioctl_count(master_config.port) - before;
+    printf("%s: %.2f degC, %.2f hPa, %llu ioctl(s) per register read\n", name, temp, press,
+        (unsigned long long) ioctls);
+    failed += ret != ESP_OK;
+    failed += ioctls != 1;
+    failed += temp < 25.0f || temp > 25.2f;  // Model's default: datasheet's example, 25.08 degC
+
+    // Split by libi2c into chunks the adapter takes: one ioctl each
+    size_t max = i2c_get_backend(master_config.port)->max_transfer(master_config.port);
+    before = i2c_linux_ioctl_count(master_config.port);
+    ret = i2c_read_register(&bmp280.dev, 0x00, big, BIG_LEN);
+    ioctls = i2c_linux_ioctl_count(master_config.port) - before;
+    printf("%s: %d-byte register read, %s in %llu ioctl(s) of up to %zu bytes\n", name, BIG_LEN,
+        ret == ESP_OK ? "ok" : "failed", (unsigned long long) ioctls, max);
+    failed += ret != ESP_OK;
+    failed += ioctls != (BIG_LEN + max - 1) / max;
+
+    struct i2c_dev_handle_t regs = {.port = master_config.port, .addr = SCRATCH};
+    i2c_write_register(&regs, 0x00, big, 1);  // SMBus adapters: one more ioctl to switch slave, not counted below
+    before = i2c_linux_ioctl_count(master_config.port);
+    ret = i2c_write_register(&regs, 0x00, big, BIG_LEN);
+    ioctls = i2c_linux_ioctl_count(master_config.port) - before;
+    printf("%s: %d-byte register write, %s in %llu ioctl(s)\n", name, BIG_LEN, ret == ESP_OK ? "ok" : "failed",
+        (unsigned long long) ioctls);
+    failed += ret != ESP_OK;
+    failed += ioctls != (BIG_LEN + max - 1) / max;
+
+    i2c_deinit();
+    return failed;
+}
+
+int main(void) {
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&fake_bmp280, BMP280_ADDR_PRIMARY));
+    i2c_sim_attach(PORT_1, i2c_sim_regs_init(&scratch, SCRATCH));
+    int failed = run("I2C_RDWR", I2C_LINUX_FUNCS_FULL);
+    failed += run("I2C_RDWR, no NOSTART", I2C_LINUX_FUNCS_FULL & ~I2C_FUNC_NOSTART);
+    failed += run("SMBus", I2C_LINUX_FUNCS_SMBUS);
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file host_recovery.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: a simulated slave holding SDA low. The transaction times out, libi2c recovers the
+ *  bus on its own, the observer is told and the counters keep track; a slave stuck harder needs i2c_bus_recover()
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_stats.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <stdio.h>
+
+static struct bmp280_sim_t fake_bmp280;
+static struct i2c_recovery_event_t last;
+static unsigned events;
+static int failed;
+
+static void on_recovery(const struct i2c_recovery_event_t *ev, void *arg) {
+    (void) arg;
+    last = *ev;
+    events++;
+    printf("  recovery on port %d, addr 0x%02x: %u pulse(s), %s\n", ev->port, ev->addr, ev->pulses,
+        ev->result == ESP_OK ? "bus free" : "SDA still low");
+}
+
+static void check(bool ok, const char *what) {
+    printf("%-52s %s\n", what, ok ? "ok" : "FAILED");
+    failed += !ok;
+}
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_set_recovery_callback(PORT_1, on_recovery, NULL);  // Before i2c_init is fine
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&fake_bmp280, BMP280_ADDR_PRIMARY));
+    i2c_init(&master_config);
+
+    struct i2c_dev_handle_t dev = {.port = PORT_1, .addr = BMP280_ADDR_PRIMARY, .timeout_ms = 5};
+    u8 id;
+
+    // Stuck mid-byte: 5 pulses, within what one recovery gives
+    i2c_sim_hold_sda(PORT_1, 5);
+    check(i2c_read_register(&dev, BMP280_REG_ID, &id, 1) == ESP_ERR_TIMEOUT, "read with SDA held times out");
+    check(events == 1 && last.addr == dev.addr && last.pulses == 5 && last.result == ESP_OK, "automatic recovery frees the bus");
+    check(i2c_read_register(&dev, BMP280_REG_ID, &id, 1) == ESP_OK && id == BMP280_CHIP_ID, "next read goes through");
+
+    // Stuck harder: 20 pulses, the automatic recovery isn't enough
+    i2c_sim_hold_sda(PORT_1, 20);
+    check(i2c_read_register(&dev, BMP280_REG_ID, &id, 1) == ESP_ERR_TIMEOUT, "read with SDA held times out");
+    check(events == 2 && last.pulses == 9 && last.result == ESP_FAIL, "automatic recovery: SDA still low");
+    check(i2c_bus_recover(PORT_1) == ESP_FAIL && last.addr == I2C_ADDR_NONE, "i2c_bus_recover: SDA still low");
+    check(i2c_bus_recover(PORT_1) == ESP_OK && last.pulses == 2, "i2c_bus_recover: bus free");
+    check(i2c_read_register(&dev, BMP280_REG_ID, &id, 1) == ESP_OK, "next read goes through");
+
+    struct i2c_stats_t port_stats, dev_stats;
+    i2c_stats_get_port(PORT_1, &port_stats);
+    i2c_stats_get_dev(&dev, &dev_stats);
+    printf("Port: %u timeouts, %u recoveries. Device: %u timeouts, %u recoveries\n", (unsigned) port_stats.timeouts,
+        (unsigned) port_stats.recoveries, (unsigned) dev_stats.timeouts, (unsigned) dev_stats.recoveries);
+    check(port_stats.timeouts == 2 && port_stats.recoveries == 4 && dev_stats.recoveries == 2, "counters");
+
+    i2c_deinit();
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file host_regcache.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: BMP280 register cache on the simulated bus. Counts the transactions each access
+ *  puts on the wire: cached registers are read once, unchanged writes are skipped, write-through ones never are
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_regcache.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <stdio.h>
+
+static struct bmp280_sim_t fake_bmp280;
+static int failed;
+
+static uint64_t transactions(void) {
+    struct i2c_sim_stats_t stats;
+    i2c_sim_get_stats(PORT_1, &stats);
+    return stats.transactions;
+}
+
+static void check(bool ok, const char *what, uint64_t bus) {
+    printf("%-44s %3llu transaction(s)  %s\n", what, (unsigned long long) bus, ok ? "ok" : "FAILED");
+    failed += !ok;
+}
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&fake_bmp280, BMP280_ADDR_PRIMARY));
+    i2c_init(&master_config);
+
+    struct bmp280_t bmp280;
+    struct i2c_regcache_t cache;
+    if (bmp280_init(&bmp280, PORT_1, BMP280_ADDR_PRIMARY) != ESP_OK)
+        return 1;
+    bmp280_use_cache(&bmp280, &cache);
+    uint64_t t;
+
+    t = transactions();
+    bmp280_read_calib(&bmp280);
+    t = transactions() - t;
+    check(t == 1, "calibration, first read", t);
+    t = transactions();
+    bmp280_read_calib(&bmp280);
+    t = transactions() - t;
+    check(t == 0 && cache.stats.hits == 1, "calibration, second read (cached)", t);
+
+    u8 config = 0x90, val;
+    i2c_write_register(&bmp280.dev, BMP280_REG_CONFIG, &config, 1);
+    t = transactions();
+    i2c_write_register(&bmp280.dev, BMP280_REG_CONFIG, &config, 1);
+    t = transactions() - t;
+    check(t == 0 && cache.stats.suppressed == 1, "config, same value again (skipped)", t);
+    t = transactions();
+    i2c_read_register(&bmp280.dev, BMP280_REG_CONFIG, &val, 1);
+    t = transactions() - t;
+    check(t == 0 && val == config, "config, read back", t);
+
+    u8 ctrl_meas = BMP280_CTRL_MEAS(BMP280_OSRS_X16, BMP280_OSRS_X16, BMP280_MODE_FORCED);
+    bmp280_set_ctrl_meas(&bmp280, ctrl_meas);
+    t = transactions();
+    bmp280_set_ctrl_meas(&bmp280, ctrl_meas);
+    t = transactions() - t;
+    check(t == 1, "ctrl_meas, same value again (write-through)", t);
+    t = transactions();
+    bmp280_set_mode(&bmp280, BMP280_MODE_FORCED);  // i2c_update_bits: read from RAM, write on the bus
+    t = transactions() - t;
+    check(t == 1 && fake_bmp280.regs.regs[BMP280_REG_CTRL_MEAS] == ctrl_meas, "ctrl_meas, update_bits (write only)", t);
+    t = transactions();
+    bmp280_set_mode(&bmp280, BMP280_MODE_SLEEP);
+    t = transactions() - t;
+    check(t == 1 && (fake_bmp280.regs.regs[BMP280_REG_CTRL_MEAS] & BMP280_CTRL_MEAS_MODE) == BMP280_MODE_SLEEP,
+        "ctrl_meas, update_bits to sleep mode", t);
+
+    i2c_regcache_invalidate(&bmp280.dev);
+    t = transactions();
+    bmp280_read_calib(&bmp280);
+    t = transactions() - t;
+    check(t == 1, "calibration after invalidate", t);
+
+    struct i2c_regcache_stats_t stats;
+    i2c_regcache_get_stats(&cache, &stats);
+    printf("Cache: %u hits, %u misses, %u writes, %u suppressed\n", (unsigned) stats.hits, (unsigned) stats.misses,
+        (unsigned) stats.writes, (unsigned) stats.suppressed);
+    i2c_deinit();
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
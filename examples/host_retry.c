@@ -0,0 +1,135 @@
+/**
+ * @file host_retry.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: retry policy and circuit breaker on the simulated bus. A device that doesn't answer
+ *  is retried within its budget, trips the breaker, gets rejected without bus traffic, fails its half-open probe,
+ *  comes back, and meanwhile a healthy sensor on the same port keeps being served
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_retry.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#define FLAKY_ADDR      (0x50)
+#define OPEN_MS         (50)
+
+static struct bmp280_sim_t fake_bmp280;
+static struct i2c_sim_regs_t flaky_model;
+static int failed;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void sleep_ms(unsigned ms) {
+    struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long) (ms % 1000) * 1000000};
+    nanosleep(&ts, NULL);
+}
+
+static uint64_t transactions(void) {
+    struct i2c_sim_stats_t stats;
+    i2c_sim_get_stats(PORT_1, &stats);
+    return stats.transactions;
+}
+
+static void check(bool ok, const char *what, const struct i2c_dev_handle_t *dev) {
+    struct i2c_retry_stats_t s;
+    i2c_retry_get_stats(dev, &s);
+    printf("%-44s retries %2u, exhausted %u, rejected %u, trips %u  %s\n", what, (unsigned) s.retries,
+        (unsigned) s.exhausted, (unsigned) s.rejected, (unsigned) s.trips, ok ? "ok" : "FAILED");
+    failed += !ok;
+}
+
+static esp_err_t poke(const struct i2c_dev_handle_t *dev) {
+    u8 val;
+    return i2c_read_register(dev, 0x00, &val, 1);
+}
+
+static void *failing(void *arg) {
+    poke(arg);
+    return NULL;
+}
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&fake_bmp280, BMP280_ADDR_PRIMARY));
+    i2c_sim_regs_init(&flaky_model, FLAKY_ADDR);  // Not attached yet: every transaction is NACKed
+    i2c_init(&master_config);
+
+    struct i2c_dev_handle_t dev = {.port = PORT_1, .addr = FLAKY_ADDR};
+    struct i2c_retry_t policy;
+    struct i2c_retry_stats_t s;
+    i2c_retry_init(&policy);
+    policy.open_ms = OPEN_MS;
+    i2c_retry_attach(&dev, &policy);
+
+    // Attempts: first + 2 retries, then the failure counts towards the breaker
+    esp_err_t ret = poke(&dev);
+    i2c_retry_get_stats(&dev, &s);
+    check(ret == ESP_FAIL && s.retries == I2C_RETRY_ATTEMPTS - 1 && s.exhausted == 1, "NACK: retried, then exhausted", &dev);
+    poke(&dev);
+    poke(&dev);
+    check(i2c_retry_is_open(&dev), "third failure trips the breaker", &dev);
+
+    uint64_t t = transactions();
+    check(poke(&dev) == I2C_ERR_CIRCUIT_OPEN && transactions() == t, "open: rejected without bus traffic", &dev);
+
+    sleep_ms(OPEN_MS + 10);
+    t = transactions();
+    check(poke(&dev) == ESP_FAIL && transactions() - t == 1 && policy.open_period_ms == 2 * OPEN_MS,
+        "half-open probe fails: one attempt, longer open", &dev);
+
+    i2c_sim_attach(PORT_1, &flaky_model.dev);  // Device back
+    sleep_ms(2 * OPEN_MS + 10);
+    check(poke(&dev) == ESP_OK && !i2c_retry_is_open(&dev), "half-open probe succeeds: closed", &dev);
+
+    i2c_sim_detach(PORT_1, &flaky_model.dev);
+    for (int i = 0; i < I2C_RETRY_TRIP; i++)
+        poke(&dev);
+    i2c_retry_reset(&dev);
+    t = transactions();
+    check(!i2c_retry_is_open(&dev) && poke(&dev) == ESP_FAIL && transactions() > t, "reset closes the breaker", &dev);
+
+    // Budget: long backoffs, many attempts; the budget cuts them short
+    struct i2c_dev_handle_t slow = {.port = PORT_1, .addr = FLAKY_ADDR};
+    struct i2c_retry_t slow_policy;
+    i2c_retry_init(&slow_policy);
+    slow_policy.attempts = 100;
+    slow_policy.backoff_ms = slow_policy.backoff_max_ms = 8;
+    slow_policy.budget_ms = 30;
+    slow_policy.trip = 0;
+    i2c_retry_attach(&slow, &slow_policy);
+    double t0 = now_ms();
+    ret = poke(&slow);
+    double elapsed = now_ms() - t0;
+    i2c_retry_get_stats(&slow, &s);
+    check(ret == ESP_FAIL && s.retries < 10 && elapsed < slow_policy.budget_ms + 10, "budget stops the retries", &slow);
+
+    // A failing device backing off doesn't hold up the healthy one
+    pthread_t thread;
+    struct bmp280_t bmp280;
+    float temp, press;
+    bmp280_init(&bmp280, PORT_1, BMP280_ADDR_PRIMARY);
+    pthread_create(&thread, NULL, failing, &slow);
+    double worst = 0;
+    for (t0 = now_ms(); now_ms() - t0 < slow_policy.budget_ms;) {
+        double r0 = now_ms();
+        bmp280_read(&bmp280, &temp, &press);
+        worst = now_ms() - r0 > worst ? now_ms() - r0 : worst;
+    }
+    pthread_join(thread, NULL);
+    printf("Healthy sensor during the other one's backoff: worst read %.2f ms\n", worst);
+    failed += worst >= slow_policy.backoff_ms;  // Would be a whole backoff with the lock held
+
+    i2c_deinit();
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file host_ring.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Sample ring on a Linux host: one producer thread pushing as fast as it can, consumers reading at their own
+ *  pace, one sample at a time or aggregated. Every sample carries its own index, so a torn copy, a sample seen twice
+ *  or a miscounted loss shows up
+ */
+
+#include <sample_ring.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#define SAMPLES     (500000)  // Indexes stay exact as floats (< 2^24), so do the values
+#define BURST       (32)  // The producer pauses after each burst, so that consumers get to run even on one core
+#define READERS     (3)
+
+static struct sample_ring_t ring;
+static volatile bool done;
+
+struct consumer_t {
+    struct sample_reader_t reader;
+    unsigned pause_every;  // Sleep every that many reads, 0 never: a slow consumer gets lapped
+    bool aggregate;
+    uint32_t read;
+    uint32_t torn;
+    uint32_t order;  // Samples out of order, repeated or skipped without being counted as lost
+};
+
+static void fill(struct sample_t *s, uint32_t idx) {
+    s->ts_us = idx;
+    for (int c = 0; c < SAMPLE_CHANNELS; c++)
+        s->value[c] = (float) idx * (c + 1);
+}
+
+static bool whole(const struct sample_t *s) {
+    for (int c = 0; c < SAMPLE_CHANNELS; c++) {
+        if (s->value[c] != (float) s->ts_us * (c + 1))
+            return false;
+    }
+    return true;
+}
+
+static void *producer(void *arg) {
+    (void) arg;
+    struct sample_t s;
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        fill(&s, i);
+        sample_ring_push(&ring, &s);
+        if (!(i % BURST)) {
+            struct timespec ts = {.tv_nsec = 10000};
+            nanosleep(&ts, NULL);
+        }
+    }
+    done = true;
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    struct consumer_t *c = arg;
+    struct sample_t s;
+    struct sample_agg_t agg;
+    int64_t expected = 0;  // Index of the next sample, counting the lost ones as read
+    while (true) {
+        bool last = done;  // Checked before reading: what's pushed by then gets drained
+        size_t n;
+        if (c->aggregate) {
+            uint32_t lost = c->reader.lost;
+            n = sample_ring_aggregate(&ring, &c->reader, 16, &agg);
+            if (n) {
+                // Indexes are the values: a consistent run has min = first, max = last, and is as long as it spans
+                c->torn += agg.min[0] != agg.first_us || agg.max[0] != agg.last_us;
+                c->order += agg.first_us < expected || agg.last_us + 1 - expected != (int64_t) (n + c->reader.lost - lost);
+                expected = agg.last_us + 1;
+            }
+        } else {
+            n = sample_ring_read(&ring, &c->reader, &s);
+            if (n) {
+                c->torn += !whole(&s);
+                c->order += s.ts_us != expected + (c->reader.lost - (uint32_t) (expected - c->read));
+                expected = s.ts_us + 1;
+            }
+        }
+        c->read += (uint32_t) n;
+        if (!n && last)
+            break;
+        if (c->pause_every && n && !(c->read % c->pause_every)) {
+            struct timespec ts = {.tv_nsec = 50000};
+            nanosleep(&ts, NULL);
+        }
+    }
+    c->order += c->read + c->reader.lost != SAMPLES;
+    return NULL;
+}
+
+int main(void) {
+    int failed = 0;
+
+    // Single-threaded first: an overrun costs exactly the overwritten samples
+    struct sample_reader_t reader;
+    struct sample_t s;
+    sample_ring_init(&ring);
+    sample_ring_reader_init(&ring, &reader);
+    for (uint32_t i = 0; i < SAMPLE_RING_SIZE + 10; i++) {
+        fill(&s, i);
+        sample_ring_push(&ring, &s);
+    }
+    bool ok = sample_ring_read(&ring, &reader, &s) && s.ts_us == 10 && reader.lost == 10;
+    printf("Overrun by 10 samples: first read %lld, %u lost  %s\n", (long long) s.ts_us, (unsigned) reader.lost,
+        ok ? "ok" : "FAILED");
+    failed += !ok;
+
+    struct consumer_t consumers[READERS] = {
+        {.pause_every = 0},
+        {.pause_every = 1000},
+        {.aggregate = true, .pause_every = 100},
+    };
+    sample_ring_init(&ring);
+    for (int i = 0; i < READERS; i++)
+        sample_ring_reader_init(&ring, &consumers[i].reader);
+    pthread_t threads[READERS + 1];
+    for (int i = 0; i < READERS; i++)
+        pthread_create(&threads[i], NULL, consumer, &consumers[i]);
+    pthread_create(&threads[READERS], NULL, producer, NULL);
+    for (int i = 0; i <= READERS; i++)
+        pthread_join(threads[i], NULL);
+
+    for (int i = 0; i < READERS; i++) {
+        struct consumer_t *c = &consumers[i];
+        ok = !c->torn && !c->order;
+        printf("Consumer %d (%s, pause every %u): %u read, %u lost, %u torn, %u out of order  %s\n", i,
+            c->aggregate ? "aggregate" : "one by one", c->pause_every, (unsigned) c->read, (unsigned) c->reader.lost,
+            (unsigned) c->torn, (unsigned) c->order, ok ? "ok" : "FAILED");
+        failed += !ok;
+    }
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file host_scan.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: bus scan on the simulated bus. Two BMP280, an MPU6050 with its AD0 strap high, an
+ *  SSD1306, a register file with a wrong id at the MPU6050's other address and an unknown device; then one of the
+ *  sensors is unplugged and the next scan tells
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_scan.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <ssd1306_fb.h>
+#include <ssd1306_sim.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MPU6050_ADDR        (0x69)  // AD0 high
+#define MPU6050_WHO_AM_I    (0x75)
+#define IMPOSTOR_ADDR       (0x68)  // Where an MPU6050 could be, but its id register says otherwise
+#define UNKNOWN_ADDR        (0x50)
+
+static struct bmp280_sim_t bmp_primary, bmp_secondary;
+static struct ssd1306_sim_t oled;
+static struct i2c_sim_regs_t mpu6050, impostor, unknown;
+static int failed;
+
+static void check(bool ok, const char *what) {
+    printf("%-52s %s\n", what, ok ? "ok" : "FAILED");
+    failed += !ok;
+}
+
+static const char *name_at(const struct i2c_registry_t *registry, i2c_addr_t addr) {
+    for (size_t i = 0; i < registry->n; i++) {
+        if (registry->devs[i].dev.addr == addr)
+            return registry->devs[i].fp ? registry->devs[i].fp->name : "unknown";
+    }
+    return NULL;
+}
+
+static bool named(const struct i2c_registry_t *registry, i2c_addr_t addr, const char *name) {
+    const char *found = name_at(registry, addr);
+    return found && !strcmp(found, name);
+}
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_port_t port = master_config.port;
+    i2c_sim_attach(port, bmp280_sim_init(&bmp_primary, BMP280_ADDR_PRIMARY));
+    i2c_sim_attach(port, bmp280_sim_init(&bmp_secondary, BMP280_ADDR_SECONDARY));
+    i2c_sim_attach(port, ssd1306_sim_init(&oled, SSD1306_FB_ADDR));
+    i2c_sim_attach(port, i2c_sim_regs_init(&mpu6050, MPU6050_ADDR));
+    mpu6050.regs[MPU6050_WHO_AM_I] = 0x68;  // Same id whatever the strap
+    i2c_sim_attach(port, i2c_sim_regs_init(&impostor, IMPOSTOR_ADDR));
+    i2c_sim_attach(port, i2c_sim_regs_init(&unknown, UNKNOWN_ADDR));
+    i2c_init(&master_config);
+
+    struct i2c_registry_t registry, last;
+    check(i2c_scan(port, &registry, NULL) == ESP_OK && registry.found == 6 && registry.n == 6, "6 devices answer");
+    for (size_t i = 0; i < registry.n; i++) {
+        const struct i2c_registry_entry_t *entry = &registry.devs[i];
+        printf("  0x%02x: %s\n", entry->dev.addr, entry->fp ? entry->fp->name : "unknown");
+    }
+    check(named(&registry, BMP280_ADDR_PRIMARY, "bmp280") && named(&registry, BMP280_ADDR_SECONDARY, "bmp280"),
+        "both BMP280 by chip id");
+    check(named(&registry, MPU6050_ADDR, "mpu6050"), "MPU6050 by WHO_AM_I, AD0 high");
+    check(named(&registry, SSD1306_FB_ADDR, "ssd1306"), "SSD1306 by address only");
+    check(named(&registry, IMPOSTOR_ADDR, "unknown") && named(&registry, UNKNOWN_ADDR, "unknown"),
+        "wrong id and no fingerprint: unknown");
+
+    const struct i2c_dev_handle_t *second = i2c_registry_find(&registry, "bmp280", 1);
+    check(second && second->addr == BMP280_ADDR_SECONDARY && !i2c_registry_find(&registry, "bmp280", 2),
+        "second bmp280 found, no third");
+    u8 id;
+    check(second && i2c_read_register(second, BMP280_REG_ID, &id, 1) == ESP_OK && id == BMP280_CHIP_ID,
+        "registry handle is ready to use");
+
+    last = registry;
+    i2c_sim_detach(port, &bmp_secondary.regs.dev);
+    check(i2c_scan(port, &registry, NULL) == ESP_OK && registry.found == 5
+        && memcmp(registry.present, last.present, sizeof(last.present))
+        && !i2c_registry_present(&registry, BMP280_ADDR_SECONDARY) && i2c_registry_present(&last, BMP280_ADDR_SECONDARY),
+        "unplugged BMP280 missing from the next scan");
+
+    i2c_deinit();
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
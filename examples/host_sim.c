@@ -0,0 +1,43 @@
+/**
+ * @file host_sim.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: BMP280 readout from a simulated sensor attached to the simulated bus
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_stats.h>
+#include <bmp280.h>
+#include <bmp280_sim.h>
+#include <stdio.h>
+
+static struct bmp280_sim_t fake_bmp280;
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_sim_attach(PORT_1, bmp280_sim_init(&fake_bmp280, BMP280_ADDR_PRIMARY));
+    i2c_init(&master_config);
+
+    struct bmp280_t bmp280;
+    float temp, press;
+    if (bmp280_init(&bmp280, PORT_1, BMP280_ADDR_PRIMARY) != ESP_OK)
+        return 1;
+    bmp280_set_ctrl_meas(&bmp280, BMP280_CTRL_MEAS(BMP280_OSRS_X16, BMP280_OSRS_X16, BMP280_MODE_NORMAL));
+    if (bmp280_read(&bmp280, &temp, &press) != ESP_OK)
+        return 1;
+    printf("Temperature: %.2f\nPressure: %.2f\n", temp, press);
+
+    struct i2c_sim_stats_t stats;
+    i2c_sim_get_stats(PORT_1, &stats);
+    printf("Transactions: %llu, bytes: %llu, bus time: %llu ns\n",
+        (unsigned long long) stats.transactions, (unsigned long long) stats.bytes, (unsigned long long) stats.bus_time_ns);
+
+    struct i2c_stats_t dev_stats;
+    if (i2c_stats_get_dev(&bmp280.dev, &dev_stats) == ESP_OK)
+        printf("BMP280: %u transactions, %u NACKs, p50 < %u us, p99 < %u us\n", (unsigned) dev_stats.transactions,
+            (unsigned) dev_stats.nacks, (unsigned) i2c_stats_percentile(&dev_stats, 50), (unsigned) i2c_stats_percentile(&dev_stats, 99));
+
+    i2c_deinit();
+    return 0;
+}
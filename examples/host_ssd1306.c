@@ -0,0 +1,62 @@
+/**
+ * @file host_ssd1306.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: SSD1306 framebuffer on the simulated controller. The display instance lives on the
+ *  stack, filled with garbage, and GDDRAM starts out random: init must still send exactly one clean frame
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <ssd1306_fb.h>
+#include <ssd1306_sim.h>
+#include <stdio.h>
+#include <string.h>
+
+static struct ssd1306_sim_t oled;
+static int failed;
+
+static void check(bool ok, const char *what) {
+    printf("%-52s %s\n", what, ok ? "ok" : "FAILED");
+    failed += !ok;
+}
+
+static bool ram_blank(void) {
+    for (int page = 0; page < SSD1306_FB_PAGES; page++) {
+        for (int col = 0; col < SSD1306_FB_WIDTH; col++) {
+            if (oled.ram[page][col])
+                return false;
+        }
+    }
+    return true;
+}
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    i2c_sim_attach(master_config.port, ssd1306_sim_init(&oled, SSD1306_FB_ADDR));
+    memset(oled.ram, 0x5a, sizeof(oled.ram));  // GDDRAM content is random at power on
+    i2c_init(&master_config);
+
+    struct ssd1306_t disp;
+    memset(&disp, 0xc8, sizeof(disp));  // Whatever was on the stack
+    check(ssd1306_fb_init(&disp, master_config.port, SSD1306_FB_ADDR) == ESP_OK, "init on a non-zeroed instance");
+    check(ram_blank() && oled.data_bytes == SSD1306_FB_PAGES * SSD1306_FB_WIDTH, "one full blank frame sent");
+
+    uint32_t before = oled.data_bytes;
+    ssd1306_fb_flush(&disp);
+    check(oled.data_bytes == before, "nothing left dirty");
+
+    ssd1306_fb_pixel(&disp, 100, 40, true);
+    ssd1306_fb_flush(&disp);
+    check(ssd1306_sim_pixel(&oled, 100, 40) && oled.data_bytes - before == 1, "one pixel, one byte");
+
+    // Re-init over a used instance: same result as a fresh one
+    ssd1306_fb_hline(&disp, 0, SSD1306_FB_WIDTH - 1, 10);
+    before = oled.data_bytes;
+    check(ssd1306_fb_init(&disp, master_config.port, SSD1306_FB_ADDR) == ESP_OK && ram_blank()
+        && oled.data_bytes - before == SSD1306_FB_PAGES * SSD1306_FB_WIDTH, "re-init clears the display");
+
+    i2c_deinit();
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
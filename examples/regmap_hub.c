@@ -0,0 +1,75 @@
+/**
+ * @file regmap_hub.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief ESP32 as a sensor hub: BMP280 sampled on PORT_1 (master), readings exposed as a register map on PORT_0
+ *  (slave, 0x28) to another controller
+ */
+
+#include <libi2c.h>
+#include <bmp280.h>
+#include <i2c_regmap.h>
+#include <string.h>
+
+#define HUB_ADDR        (0x28)
+#define HUB_REG_ID      (0x00)  // HUB_ID
+#define HUB_REG_SEQ     (0x01)  // Incremented at each publish
+#define HUB_REG_TEMP    (0x02)  // int32 LE, centi-degC
+#define HUB_REG_PRESS   (0x06)  // int32 LE, Pa
+#define HUB_REG_PERIOD  (0x10)  // Writable: sampling period, in 10 ms units
+#define HUB_REGS        (0x11)
+#define HUB_ID          (0x42)
+
+struct bmp280_t bmp280;
+struct i2c_regmap_t hub;
+u8 banks[2][HUB_REGS] = {[0] = {[HUB_REG_ID] = HUB_ID, [HUB_REG_PERIOD] = 10}};
+const uint32_t writable[1] = {1UL << HUB_REG_PERIOD};
+volatile uint32_t period_ms = 100;
+
+static void put_le32(u8 *dst, int32_t val) {
+    for (int i = 0; i < 4; i++)
+        dst[i] = (u8) ((uint32_t) val >> (8 * i));
+}
+
+// Runs in the slave worker: the master changed the period
+static void on_write(struct i2c_regmap_t *map, u8 reg, const u8 *data, size_t len, void *arg) {
+    (void) arg;
+    if (reg != HUB_REG_PERIOD || !len || !data[0])
+        return;
+    period_ms = data[0] * 10;
+    i2c_regmap_edit(map)[HUB_REG_PERIOD] = data[0];  // Read back as written
+    i2c_regmap_publish(map);
+}
+
+void sample_task(void *pv) {
+    float temp, press;
+    while (true) {
+        if (bmp280_read(&bmp280, &temp, &press) == ESP_OK) {
+            u8 *regs = i2c_regmap_edit(&hub);  // The master keeps reading the other bank meanwhile
+            regs[HUB_REG_SEQ]++;
+            put_le32(&regs[HUB_REG_TEMP], (int32_t) (temp * 100));
+            put_le32(&regs[HUB_REG_PRESS], (int32_t) press);
+            i2c_regmap_publish(&hub);  // Temperature and pressure change together
+        }
+        vTaskDelay(period_ms / portTICK_RATE_MS);
+    }
+}
+
+void app_main() {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();  // PORT_1
+    i2c_init(&master_config);
+    struct i2c_bus_t slave_config = init_i2c_bus_default_slave(HUB_ADDR);  // PORT_0
+    i2c_init(&slave_config);
+
+    ESP_ERROR_CHECK(bmp280_init(&bmp280, PORT_1, BMP280_ADDR_PRIMARY));
+    bmp280_reset(&bmp280);
+    ESP_ERROR_CHECK(bmp280_wait_ready(&bmp280, BMP280_READY_MS));
+    ESP_ERROR_CHECK(bmp280_read_calib(&bmp280));
+    bmp280_set_ctrl_meas(&bmp280, BMP280_CTRL_MEAS(BMP280_OSRS_X16, BMP280_OSRS_X16, BMP280_MODE_NORMAL));
+
+    ESP_ERROR_CHECK(i2c_regmap_init(&hub, banks[0], banks[1], HUB_REGS));
+    hub.writable = writable;
+    hub.on_write = on_write;
+    ESP_ERROR_CHECK(i2c_regmap_serve(PORT_0, &hub, 0));  // Slave on core 0, sampling wherever
+    xTaskCreate(&sample_task, "sample", 2048, NULL, 5, NULL);
+}
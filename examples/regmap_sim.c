@@ -0,0 +1,114 @@
+/**
+ * @file regmap_sim.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief libi2c on a Linux host: register map slave on the simulated bus. A producer thread keeps publishing blocks
+ *  whose bytes are all equal while the master reads them back; a torn read would mix two values. Then a write longer
+ *  than I2C_REGMAP_WRITE_MAX, reported in pieces from the right registers, and a read-only register NACKing
+ */
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+#include <i2c_regmap.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SLAVE_ADDR      (0x28)
+#define BLOCK           (16)  // Registers 0x00...0x0f, published together
+#define REG_CTRL        (0x20)  // Writable
+#define REG_BUF         (0x30)  // Writable, BUF_LEN registers
+#define BUF_LEN         (I2C_REGMAP_WRITE_MAX + 8)
+#define REGS            (REG_BUF + BUF_LEN)
+#define READS           (20000)
+
+static struct i2c_regmap_t map;
+static u8 banks[2][REGS];
+static uint32_t writable[(REGS + 31) / 32];
+static volatile bool done;
+static unsigned publishes;
+static u8 ctrl;
+static u8 buf[BUF_LEN];
+static unsigned buf_writes;
+static bool buf_order = true;  // Each piece starts where the previous one ended
+
+static void *producer(void *arg) {
+    (void) arg;
+    for (u8 val = 1; !done; val++) {
+        u8 *regs = i2c_regmap_edit(&map);
+        for (int i = 0; i < BLOCK; i++)
+            regs[i] = val;
+        i2c_regmap_publish(&map);
+        publishes++;
+        struct timespec ts = {.tv_nsec = 20000};  // Let the master in
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+static void on_write(struct i2c_regmap_t *m, u8 reg, const u8 *data, size_t len, void *arg) {
+    (void) m, (void) arg;
+    if (reg == REG_CTRL && len == 1)
+        ctrl = data[0];
+    if (reg >= REG_BUF) {
+        buf_order &= reg == REG_BUF + buf_writes * I2C_REGMAP_WRITE_MAX && reg - REG_BUF + len <= BUF_LEN;
+        for (size_t i = 0; i < len && reg - REG_BUF + i < BUF_LEN; i++)
+            buf[reg - REG_BUF + i] = data[i];
+        buf_writes++;
+    }
+}
+
+int main(void) {
+    struct i2c_bus_t master_config = init_i2c_bus_default_master();
+    struct i2c_dev_handle_t dev = {.port = master_config.port, .addr = SLAVE_ADDR};
+    if (i2c_regmap_init(&map, banks[0], banks[1], REGS) != ESP_OK)
+        return 1;
+    for (unsigned reg = REG_BUF; reg < REGS; reg++)
+        writable[reg / 32] |= 1UL << (reg % 32);
+    writable[REG_CTRL / 32] |= 1UL << (REG_CTRL % 32);
+    map.writable = writable;
+    map.on_write = on_write;
+    i2c_sim_attach(master_config.port, i2c_regmap_sim_init(&map, SLAVE_ADDR));
+    i2c_init(&master_config);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, producer, NULL);
+    unsigned torn = 0, changes = 0;
+    u8 block[BLOCK], last = 0;
+    for (int r = 0; r < READS; r++) {
+        if (i2c_read_register(&dev, 0x00, block, BLOCK) != ESP_OK)
+            return 1;
+        for (int i = 1; i < BLOCK; i++)
+            torn += block[i] != block[0];
+        changes += block[0] != last;
+        last = block[0];
+    }
+    done = true;
+    pthread_join(thread, NULL);
+    printf("Reads: %d, new blocks seen: %u, torn reads: %u, publishes: %u\n", READS, changes, torn, publishes);
+
+    int failed = torn != 0;
+    u8 val = 0x5a, bad = 0x11;
+    esp_err_t ret = i2c_write_register(&dev, REG_CTRL, &val, 1);
+    printf("Write to control register: %s, callback got 0x%02x\n", ret == ESP_OK ? "ok" : "failed", ctrl);
+    failed += ret != ESP_OK || ctrl != val;
+
+    // Longer than the engine's buffer: reported in pieces, each from its own register, none taken as a pointer
+    u8 data[BUF_LEN];
+    for (int i = 0; i < BUF_LEN; i++)
+        data[i] = (u8) (0x80 + i);
+    ret = i2c_write_register(&dev, REG_BUF, data, BUF_LEN);
+    bool same = !memcmp(buf, data, BUF_LEN);
+    printf("Write of %d registers: %s, %u callback(s), %s\n", BUF_LEN, ret == ESP_OK ? "ok" : "failed", buf_writes,
+        buf_order && same ? "in order" : "out of order");
+    failed += ret != ESP_OK || buf_writes != 2 || !buf_order || !same || ctrl != val;
+
+    ret = i2c_write_register(&dev, 0x00, &bad, 1);
+    printf("Write to read-only register: %s\n", ret == ESP_FAIL ? "NACKed" : "accepted");
+    failed += ret != ESP_FAIL;
+
+    i2c_deinit();
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file scan.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief List the devices on the bus and rescan every second to report hot-plug
+ */
+
+#include <libi2c.h>
+#include <i2c_scan.h>
+#include <stdio.h>
+#include <string.h>
+
+struct i2c_bus_t master_config = init_i2c_bus_default_master();
+
+void print_registry(const struct i2c_registry_t *registry) {
+    printf("%u device(s)\n", (unsigned) registry->found);
+    for (size_t i = 0; i < registry->n; i++) {
+        const struct i2c_registry_entry_t *entry = &registry->devs[i];
+        printf("0x%02x: %s\n", entry->dev.addr, entry->fp ? entry->fp->name : "unknown");
+    }
+}
+
+void app_main() {
+    struct i2c_registry_t registry, last;
+    i2c_init(&master_config);
+
+    ESP_ERROR_CHECK(i2c_scan(master_config.port, &last, NULL));
+    print_registry(&last);
+
+    while (true) {
+        vTaskDelay(1000/portTICK_RATE_MS);
+        if (i2c_scan(master_config.port, &registry, NULL) != ESP_OK)
+            continue;
+        if (memcmp(registry.present, last.present, sizeof(last.present))) {  // Something was plugged or unplugged
+            print_registry(&registry);
+            last = registry;
+        }
+    }
+}
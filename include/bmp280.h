@@ -0,0 +1,258 @@
+/**
+ * @file bmp280.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Bosch BMP280 pressure and temperature sensor driver
+ * @see BST-BMP280-DS001-11 datasheet
+ */
+
+#ifndef __BMP280_H
+#define __BMP280_H
+
+#include <libi2c.h>
+
+#define BMP280_ADDR_PRIMARY     (0x76)  // SDO to GND
+#define BMP280_ADDR_SECONDARY   (0x77)  // SDO to VDDIO
+#define BMP280_CHIP_ID          (0x58)
+
+#define BMP280_REG_CALIB        (0x88)  // 0x88...0x9f, dig_T1...dig_P9
+#define BMP280_REG_ID           (0xd0)
+#define BMP280_REG_RESET        (0xe0)
+#define BMP280_REG_STATUS       (0xf3)
+#define BMP280_REG_CTRL_MEAS    (0xf4)
+#define BMP280_REG_CONFIG       (0xf5)
+#define BMP280_REG_DATA         (0xf7)  // 0xf7...0xfc, press_msb...temp_xlsb
+
+#define BMP280_CALIB_LEN        (24)
+#define BMP280_DATA_LEN         (6)
+
+#define BMP280_RESET_VALUE      (0xb6)
+#define BMP280_STATUS_IM_UPDATE (0x01)  // NVM data being copied to image registers
+#define BMP280_STATUS_MEASURING (0x08)
+#define BMP280_RAW_SKIPPED      (0x80000)  // Raw value of a disabled measurement
+
+#define BMP280_POLL_MS          (2)  // Status polling period of bmp280_wait_ready()
+#define BMP280_READY_MS         (100)  // Reasonable bmp280_wait_ready() timeout: start-up takes 2 ms
+
+#ifndef BMP280_BATCH_BLOCK
+#define BMP280_BATCH_BLOCK      (64)  // Samples per block in bmp280_compensate_batch(), sizes two stack arrays
+#endif
+
+#define BMP280_MODE_SLEEP       (0x00)
+#define BMP280_MODE_FORCED      (0x01)
+#define BMP280_MODE_NORMAL      (0x03)
+#define BMP280_OSRS_X16         (0x05)
+#define BMP280_CTRL_MEAS(osrs_t, osrs_p, mode)  ((u8) (((osrs_t) << 5) | ((osrs_p) << 2) | (mode)))
+#define BMP280_CTRL_MEAS_OSRS   (0xfc)  // ctrl_meas field masks
+#define BMP280_CTRL_MEAS_MODE   (0x03)
+
+/**
+ * @struct bmp280_calib_t
+ * @brief trimming parameters, see datasheet's compensation parameter storage table
+ */
+struct bmp280_calib_t {
+    uint16_t dig_T1;
+    int16_t dig_T2;
+    int16_t dig_T3;
+    uint16_t dig_P1;
+    int16_t dig_P2;
+    int16_t dig_P3;
+    int16_t dig_P4;
+    int16_t dig_P5;
+    int16_t dig_P6;
+    int16_t dig_P7;
+    int16_t dig_P8;
+    int16_t dig_P9;
+};
+
+/**
+ * @struct bmp280_raw_t
+ * @var bmp280_raw_t::temp
+ *  20-bit raw temperature
+ * @var bmp280_raw_t::press
+ *  20-bit raw pressure
+ */
+struct bmp280_raw_t {
+    int32_t temp;
+    int32_t press;
+};
+
+/**
+ * @struct bmp280_t
+ * @brief driver instance. One per sensor
+ * @var bmp280_t::dev
+ *  i2c device
+ * @var bmp280_t::calib
+ *  trimming parameters, read by bmp280_init
+ * @var bmp280_t::t_fine
+ *  fine temperature from the last temperature compensation, used by pressure compensation
+ */
+struct bmp280_t {
+    struct i2c_dev_handle_t dev;
+    struct bmp280_calib_t calib;
+    int32_t t_fine;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief check the chip id and read the calibration block
+ * @param bmp driver instance
+ * @param port i2c port number. Must be initialized
+ * @param addr BMP280_ADDR_PRIMARY or BMP280_ADDR_SECONDARY
+ * @return ESP_ERR_INVALID_RESPONSE if the chip id doesn't match, bus error code otherwise
+ */
+esp_err_t bmp280_init(struct bmp280_t *bmp, i2c_port_t port, i2c_addr_t addr);
+
+/**
+ * @brief read the chip id
+ * @param bmp driver instance
+ * @param id output
+ * @return error code
+ */
+esp_err_t bmp280_read_id(struct bmp280_t *bmp, u8 *id);
+
+/**
+ * @brief read the 24-byte calibration block in a single burst
+ * @param bmp driver instance
+ * @return error code
+ */
+esp_err_t bmp280_read_calib(struct bmp280_t *bmp);
+
+/**
+ * @brief soft reset. Poll bmp280_nvm_busy() before using the sensor again
+ * @param bmp driver instance
+ * @return error code
+ */
+esp_err_t bmp280_reset(struct bmp280_t *bmp);
+
+/**
+ * @brief attach a register cache: chip id, calibration and config are read once, ctrl_meas is remembered but
+ *  always written (forced mode trigger), status and data stay on the bus. Call after bmp280_init()
+ * @param bmp driver instance
+ * @param cache cache storage. Must stay valid while in use
+ */
+void bmp280_use_cache(struct bmp280_t *bmp, struct i2c_regcache_t *cache);
+
+/**
+ * @brief check whether the calibration is still being copied from NVM, e.g. after a reset
+ * @param bmp driver instance
+ * @param busy output
+ * @return error code
+ */
+esp_err_t bmp280_nvm_busy(struct bmp280_t *bmp, bool *busy);
+
+/**
+ * @brief wait until the calibration has been copied from NVM, e.g. after a reset. The sensor may NACK meanwhile
+ * @param bmp driver instance
+ * @param timeout_ms give up after this long, e.g. BMP280_READY_MS
+ * @return ESP_ERR_TIMEOUT if the sensor didn't get ready in time
+ */
+esp_err_t bmp280_wait_ready(struct bmp280_t *bmp, uint32_t timeout_ms);
+
+/**
+ * @brief write ctrl_meas: oversampling and power mode, see BMP280_CTRL_MEAS
+ * @param bmp driver instance
+ * @param ctrl_meas register value
+ * @return error code
+ */
+esp_err_t bmp280_set_ctrl_meas(struct bmp280_t *bmp, u8 ctrl_meas);
+
+/**
+ * @brief change the power mode only, e.g. BMP280_MODE_FORCED to trigger a measurement
+ * @param bmp driver instance
+ * @param mode BMP280_MODE_SLEEP, BMP280_MODE_FORCED or BMP280_MODE_NORMAL
+ * @return error code
+ */
+esp_err_t bmp280_set_mode(struct bmp280_t *bmp, u8 mode);
+
+/**
+ * @brief change the oversampling only, keeping the power mode
+ * @param bmp driver instance
+ * @param osrs_t temperature oversampling, 0 (skipped) to BMP280_OSRS_X16
+ * @param osrs_p pressure oversampling, 0 (skipped) to BMP280_OSRS_X16
+ * @return error code
+ */
+esp_err_t bmp280_set_oversampling(struct bmp280_t *bmp, u8 osrs_t, u8 osrs_p);
+
+/**
+ * @brief read pressure and temperature raw values in a single 6-byte transaction
+ * @param bmp driver instance
+ * @param raw output
+ * @return error code
+ */
+esp_err_t bmp280_read_raw(struct bmp280_t *bmp, struct bmp280_raw_t *raw);
+
+/**
+ * @brief compensate a raw temperature. Updates bmp->t_fine
+ * @param bmp driver instance
+ * @param raw_t 20-bit raw temperature
+ * @return temperature in degrees Celsius
+ */
+float bmp280_compensate_temp(struct bmp280_t *bmp, int32_t raw_t);
+
+/**
+ * @brief compensate a raw pressure. Call bmp280_compensate_temp() on the same sample first
+ * @param bmp driver instance
+ * @param raw_p 20-bit raw pressure
+ * @return pressure in hPa, -1 on invalid calibration
+ */
+float bmp280_compensate_press(struct bmp280_t *bmp, int32_t raw_p);
+
+/**
+ * @brief compensate a raw temperature without floating point. Updates bmp->t_fine
+ * @param bmp driver instance
+ * @param raw_t 20-bit raw temperature
+ * @return temperature in hundredths of degree Celsius, 2508 is 25.08 degC
+ */
+int32_t bmp280_compensate_temp_fixed(struct bmp280_t *bmp, int32_t raw_t);
+
+/**
+ * @brief compensate a raw pressure with the datasheet's 32-bit formula: no floating point, no 64-bit
+ *  multiplication or division. Within a few Pa of bmp280_compensate_press(). Call bmp280_compensate_temp_fixed()
+ *  on the same sample first
+ * @param bmp driver instance
+ * @param raw_p 20-bit raw pressure
+ * @return pressure in Pa, 0 on invalid calibration
+ */
+uint32_t bmp280_compensate_press_fixed(struct bmp280_t *bmp, int32_t raw_p);
+
+/**
+ * @brief read and compensate a sample, fixed-point output
+ * @param bmp driver instance
+ * @param temp temperature in hundredths of degree Celsius
+ * @param press pressure in Pa
+ * @return ESP_ERR_INVALID_STATE if a measurement is disabled, bus error code otherwise
+ */
+esp_err_t bmp280_read_fixed(struct bmp280_t *bmp, int32_t *temp, uint32_t *press);
+
+/**
+ * @brief compensate arrays of raw samples, e.g. a backfill of logged data. Same results as
+ *  bmp280_compensate_temp() followed by bmp280_compensate_press() on each sample. Temperature is vectorized,
+ *  pressure runs scalar because of its 64-bit division
+ * @param calib trimming parameters of the sensor that produced the samples
+ * @param raw_t n 20-bit raw temperatures
+ * @param raw_p n 20-bit raw pressures. Unused if press is NULL
+ * @param temp n temperatures in degrees Celsius. Can be NULL
+ * @param press n pressures in hPa. Can be NULL
+ * @param n number of samples
+ */
+void bmp280_compensate_batch(const struct bmp280_calib_t *calib, const int32_t *raw_t, const int32_t *raw_p,
+        float *temp, float *press, size_t n);
+
+/**
+ * @brief read and compensate a sample
+ * @param bmp driver instance
+ * @param temp temperature in degrees Celsius
+ * @param press pressure in hPa
+ * @return ESP_ERR_INVALID_STATE if a measurement is disabled, bus error code otherwise
+ */
+esp_err_t bmp280_read(struct bmp280_t *bmp, float *temp, float *press);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __BMP280_H
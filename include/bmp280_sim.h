@@ -0,0 +1,67 @@
+/**
+ * @file bmp280_sim.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Simulated BMP280, to be attached to the simulated bus
+ */
+
+#ifndef __BMP280_SIM_H
+#define __BMP280_SIM_H
+
+#include <i2c_sim.h>
+#include <bmp280.h>
+
+#define BMP280_SIM_NVM_READS    (2)  // Status reads reporting im_update after a reset
+
+/**
+ * @struct bmp280_sim_t
+ * @brief register level model: chip id, datasheet's example calibration, soft reset, NVM copy, power modes.
+ *  Data registers latch raw_temp/raw_press when read in normal or forced mode
+ * @var bmp280_sim_t::regs
+ *  register file
+ * @var bmp280_sim_t::raw_temp
+ *  20-bit raw temperature served by the data registers
+ * @var bmp280_sim_t::raw_press
+ *  20-bit raw pressure served by the data registers
+ * @var bmp280_sim_t::nvm_reads
+ *  status reads left with im_update set
+ */
+struct bmp280_sim_t {
+    struct i2c_sim_regs_t regs;
+    int32_t raw_temp;
+    int32_t raw_press;
+    unsigned nvm_reads;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief initialize the model in its power-on state
+ * @param model model to initialize
+ * @param addr BMP280_ADDR_PRIMARY or BMP280_ADDR_SECONDARY
+ * @return pointer to the attachable device
+ */
+struct i2c_sim_dev_t *bmp280_sim_init(struct bmp280_sim_t *model, i2c_addr_t addr);
+
+/**
+ * @brief set the raw values of the next measurements. Default: datasheet's example, 25.08 degC and 1006.53 hPa
+ * @param model model
+ * @param raw_temp 20-bit raw temperature
+ * @param raw_press 20-bit raw pressure
+ */
+void bmp280_sim_set_raw(struct bmp280_sim_t *model, int32_t raw_temp, int32_t raw_press);
+
+/**
+ * @brief load a calibration block
+ * @param model model
+ * @param calib trimming parameters
+ */
+void bmp280_sim_set_calib(struct bmp280_sim_t *model, const struct bmp280_calib_t *calib);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __BMP280_SIM_H
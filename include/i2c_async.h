@@ -0,0 +1,125 @@
+/**
+ * @file i2c_async.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Asynchronous transactions: descriptors are queued to a per-port worker, which runs them back-to-back and
+ *  reports completion through a callback
+ */
+
+#ifndef __I2C_ASYNC_H
+#define __I2C_ASYNC_H
+
+#include <libi2c.h>
+#include <i2c_backend.h>
+
+#define I2C_XFER_MAX_MSGS   (4)
+
+#ifndef I2C_ASYNC_PRIO
+#define I2C_ASYNC_PRIO      (5)
+#endif
+
+struct i2c_xfer_t;
+
+/**
+ * @brief completion callback. Runs in the worker context: keep it short, don't block
+ * @param xfer completed descriptor. xfer->result holds the error code. It can be resubmitted from here
+ * @param arg user argument
+ */
+typedef void (*i2c_xfer_cb_t)(struct i2c_xfer_t *xfer, void *arg);
+
+/**
+ * @struct i2c_xfer_t
+ * @brief transaction descriptor. Owned by the caller, must stay valid until its callback has run
+ * @var i2c_xfer_t::dev
+ *  target device
+ * @var i2c_xfer_t::msgs
+ *  messages, see i2c_transfer()
+ * @var i2c_xfer_t::n
+ *  number of messages
+ * @var i2c_xfer_t::done
+ *  completion callback, can be NULL
+ * @var i2c_xfer_t::arg
+ *  callback argument
+ * @var i2c_xfer_t::result
+ *  error code, valid once done has been called
+ * @var i2c_xfer_t::reg
+ *  register address storage, so that messages can point to it (see i2c_xfer_read_register)
+ * @var i2c_xfer_t::next
+ *  used by the queue. Do not touch
+ */
+struct i2c_xfer_t {
+    const struct i2c_dev_handle_t *dev;
+    struct i2c_msg_t msgs[I2C_XFER_MAX_MSGS];
+    size_t n;
+    i2c_xfer_cb_t done;
+    void *arg;
+    esp_err_t result;
+    u8 reg;
+    struct i2c_xfer_t *next;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief start the worker of an initialized port
+ * @param port i2c port number
+ * @param core CPU to pin the worker to, -1 for no affinity (ignored on host)
+ * @return error code
+ */
+esp_err_t i2c_async_start(i2c_port_t port, int core);
+
+/**
+ * @brief stop the worker of a port, after it has drained the queue. Every descriptor accepted by i2c_submit gets
+ *  its completion callback before this returns
+ * @param port i2c port number
+ */
+void i2c_async_stop(i2c_port_t port);
+
+/**
+ * @brief queue a transaction. Returns immediately
+ * @param xfer descriptor
+ * @return ESP_ERR_INVALID_STATE if the port has no worker or it is stopping: the descriptor isn't queued
+ */
+esp_err_t i2c_submit(struct i2c_xfer_t *xfer);
+
+/**
+ * @brief fill a descriptor for a register read (see i2c_read_register)
+ * @param xfer descriptor
+ * @param dev pointer to dev handle structure
+ * @param reg first register's address on the slave
+ * @param data destination buffer
+ * @param size number of bytes to read
+ * @param done completion callback
+ * @param arg callback argument
+ * @return xfer, to be passed to i2c_submit
+ */
+struct i2c_xfer_t *i2c_xfer_read_register(struct i2c_xfer_t *xfer, const struct i2c_dev_handle_t *dev, u8 reg,
+    u8 *data, size_t size, i2c_xfer_cb_t done, void *arg);
+
+/**
+ * @brief fill a descriptor for a plain write (see i2c_write_bytes)
+ * @param xfer descriptor
+ * @param dev pointer to dev handle structure
+ * @param data bytes to send
+ * @param size data's length
+ * @param done completion callback
+ * @param arg callback argument
+ * @return xfer, to be passed to i2c_submit
+ */
+struct i2c_xfer_t *i2c_xfer_write(struct i2c_xfer_t *xfer, const struct i2c_dev_handle_t *dev, const u8 *data,
+    size_t size, i2c_xfer_cb_t done, void *arg);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief ready-made callback: notifies the task passed as arg (xTaskNotifyGive). Pair with ulTaskNotifyTake()
+ */
+void i2c_xfer_notify_task(struct i2c_xfer_t *xfer, void *task);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_ASYNC_H
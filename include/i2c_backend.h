@@ -0,0 +1,111 @@
+/**
+ * @file i2c_backend.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Transport backend interface. libi2c translates every public call into a list of messages handed to a backend
+ */
+
+#ifndef __I2C_BACKEND_H
+#define __I2C_BACKEND_H
+
+#include <libi2c.h>
+
+#define I2C_MSG_WRITE       (0x00)
+#define I2C_MSG_READ        (0x01)
+#define I2C_MSG_NOSTART     (0x02)  // Continue the previous message: no (repeated) START, no address byte
+
+/**
+ * @struct i2c_msg_t
+ * @var i2c_msg_t::buf
+ *  data to send or buffer to fill. Never copied by the backend
+ * @var i2c_msg_t::len
+ *  number of bytes. A zero-length write only addresses the slave
+ * @var i2c_msg_t::flags
+ *  I2C_MSG_READ or I2C_MSG_WRITE, optionally or-ed with I2C_MSG_NOSTART
+ */
+struct i2c_msg_t {
+    u8 *buf;
+    size_t len;
+    u8 flags;
+};
+
+/**
+ * @struct i2c_backend_t
+ * @brief a transport. Every message list is executed as a single transaction: START, messages separated
+ *  by repeated STARTs (unless I2C_MSG_NOSTART), STOP
+ * @var i2c_backend_t::name
+ *  human readable name
+ * @var i2c_backend_t::init
+ *  configure the port described by conf
+ * @var i2c_backend_t::deinit
+ *  release the port
+ * @var i2c_backend_t::transfer
+ *  run a transaction with the slave at addr. Returns ESP_OK, ESP_FAIL on NACK, ESP_ERR_TIMEOUT on timeout
+ * @var i2c_backend_t::max_transfer
+ *  largest payload a single transaction can carry, register/prefix byte excluded. 0 or NULL for no limit.
+ *  libi2c splits longer transfers
+ * @var i2c_backend_t::set_clock
+ *  change the SCL frequency of an initialized master port, between transactions. NULL if not supported
+ * @var i2c_backend_t::recover
+ *  free a stuck bus: controller reset, SCL pulses while SDA is low, STOP. Reports the pulses clocked out. Returns
+ *  ESP_OK if SDA is high afterwards, ESP_FAIL if not. NULL if not supported
+ */
+struct i2c_backend_t {
+    const char *name;
+    esp_err_t (*init)(const struct i2c_bus_t *conf);
+    esp_err_t (*deinit)(i2c_port_t port);
+    esp_err_t (*transfer)(i2c_port_t port, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n, uint32_t timeout_ms);
+    size_t (*max_transfer)(i2c_port_t port);
+    esp_err_t (*set_clock)(i2c_port_t port, uint32_t hz);
+    esp_err_t (*recover)(i2c_port_t port, unsigned *pulses);
+};
+
+#ifdef ESP_PLATFORM
+extern const struct i2c_backend_t i2c_backend_esp;
+#endif
+extern const struct i2c_backend_t i2c_backend_sim;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief get the backend bound to a port by i2c_init
+ * @param port i2c port number
+ * @return backend pointer, NULL if the port has not been initialized
+ */
+const struct i2c_backend_t *i2c_get_backend(i2c_port_t port);
+
+/**
+ * @brief run a raw transaction on the backend bound to dev's port
+ * @param dev pointer to dev handle structure
+ * @param msgs message list
+ * @param n number of messages
+ * @return error code
+ */
+esp_err_t i2c_transfer(const struct i2c_dev_handle_t *dev, struct i2c_msg_t *msgs, size_t n);
+
+/**
+ * @brief run a raw transaction with its own budget instead of dev->timeout_ms
+ * @param dev pointer to dev handle structure
+ * @param msgs message list
+ * @param n number of messages
+ * @param timeout_ms transaction timeout
+ * @return error code
+ */
+esp_err_t i2c_transfer_timeout(const struct i2c_dev_handle_t *dev, struct i2c_msg_t *msgs, size_t n, uint32_t timeout_ms);
+
+/**
+ * @brief change the SCL frequency of a master port without reinstalling the driver. Waits for the transaction in
+ *  flight, if any
+ * @param port initialized i2c port number
+ * @param hz new frequency, e.g. 1000000 for Fast-mode Plus
+ * @return ESP_ERR_NOT_SUPPORTED if the backend can't change it at runtime
+ */
+esp_err_t i2c_set_clock(i2c_port_t port, uint32_t hz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_BACKEND_H
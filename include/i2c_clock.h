@@ -0,0 +1,104 @@
+/**
+ * @file i2c_clock.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Adaptive bus clock. The tuner watches the failure rate of a port's real traffic (i2c_stats.h) and walks
+ *  the SCL frequency up a ladder toward Fast-mode Plus while windows are clean, backing off a step as soon as one
+ *  isn't. A clock that failed is retried only after a hold that doubles on every new failure, so the port settles
+ *  at the fastest clock it sustains. Changes go through i2c_set_clock(), no driver reinstall
+ */
+
+#ifndef __I2C_CLOCK_H
+#define __I2C_CLOCK_H
+
+#include <libi2c.h>
+#include <i2c_stats.h>
+
+#define I2C_CLOCK_MIN_HZ            (100000)  // Standard mode
+#define I2C_CLOCK_MAX_HZ            (1000000)  // Fast-mode Plus
+
+#ifndef I2C_CLOCK_WINDOW
+#define I2C_CLOCK_WINDOW            (256)  // Transactions per decision
+#endif
+
+#ifndef I2C_CLOCK_MAX_ERRORS_PM
+#define I2C_CLOCK_MAX_ERRORS_PM     (4)  // Failed transactions per mille tolerated in a window
+#endif
+
+#ifndef I2C_CLOCK_HOLD
+#define I2C_CLOCK_HOLD              (8)  // Clean windows before retrying a failed clock, doubled on each failure
+#endif
+
+#define I2C_CLOCK_HOLD_MAX          (1024)
+
+/**
+ * @struct i2c_clock_tuner_t
+ * @brief one per port. Fields before hz can be changed after i2c_clock_tuner_init()
+ * @var i2c_clock_tuner_t::min_hz
+ *  never go below
+ * @var i2c_clock_tuner_t::max_hz
+ *  never go above
+ * @var i2c_clock_tuner_t::window
+ *  transactions per decision
+ * @var i2c_clock_tuner_t::max_errors_pm
+ *  failed transactions per mille tolerated in a window
+ * @var i2c_clock_tuner_t::count_nacks
+ *  count NACKs as failures. Clear it if the application probes absent devices
+ * @var i2c_clock_tuner_t::hz
+ *  current clock
+ * @var i2c_clock_tuner_t::bad_hz
+ *  lowest clock that failed, 0 if none is known
+ * @var i2c_clock_tuner_t::hold
+ *  clean windows required before retrying bad_hz
+ * @var i2c_clock_tuner_t::clean
+ *  clean windows at the current clock
+ * @var i2c_clock_tuner_t::ups
+ *  clock increases
+ * @var i2c_clock_tuner_t::downs
+ *  clock decreases
+ * @var i2c_clock_tuner_t::last
+ *  port counters at the start of the window
+ */
+struct i2c_clock_tuner_t {
+    i2c_port_t port;
+    uint32_t min_hz;
+    uint32_t max_hz;
+    uint32_t window;
+    uint32_t max_errors_pm;
+    bool count_nacks;
+    uint32_t hz;
+    uint32_t bad_hz;
+    uint32_t hold;
+    uint32_t clean;
+    uint32_t ups;
+    uint32_t downs;
+    struct i2c_stats_t last;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief set up a tuner with the default limits and apply the starting clock
+ * @param tuner tuner
+ * @param port initialized i2c port number
+ * @param start_hz starting clock, e.g. conf.master.clk_speed
+ * @return ESP_ERR_NOT_SUPPORTED if the backend can't change the clock at runtime or statistics are compiled out
+ */
+esp_err_t i2c_clock_tuner_init(struct i2c_clock_tuner_t *tuner, i2c_port_t port, uint32_t start_hz);
+
+/**
+ * @brief evaluate the traffic since the last decision and move the clock if needed. Call it periodically, e.g.
+ *  from the sampling task; nothing happens until a window's worth of transactions went by, unless failures already
+ *  exceed what a whole window tolerates
+ * @param tuner tuner
+ * @return error code of i2c_set_clock(), ESP_OK if the clock didn't change
+ */
+esp_err_t i2c_clock_tuner_step(struct i2c_clock_tuner_t *tuner);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_CLOCK_H
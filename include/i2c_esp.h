@@ -0,0 +1,52 @@
+/**
+ * @file i2c_esp.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief ESP-IDF backend specifics
+ */
+
+#ifndef __I2C_ESP_H
+#define __I2C_ESP_H
+
+#ifdef ESP_PLATFORM
+
+#include <libi2c.h>
+#include <i2c_backend.h>
+
+#ifndef I2C_CMD_POOL_SLOTS
+#define I2C_CMD_POOL_SLOTS          (2)  // Command links per port that can be built concurrently without heap
+#endif
+#ifndef I2C_CMD_POOL_TRANSACTIONS
+#define I2C_CMD_POOL_TRANSACTIONS   (4)  // Size of each slot, see I2C_LINK_RECOMMENDED_SIZE
+#endif
+
+/**
+ * @struct i2c_cmd_pool_stats_t
+ * @var i2c_cmd_pool_stats_t::static_links
+ *  command links built in pool storage
+ * @var i2c_cmd_pool_stats_t::heap_links
+ *  command links that fell back to i2c_cmd_link_create(): pool exhausted or transaction too long for a slot
+ */
+struct i2c_cmd_pool_stats_t {
+    uint32_t static_links;
+    uint32_t heap_links;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief get command link allocation counters of a port
+ * @param port i2c port number
+ * @param stats output
+ */
+void i2c_esp_get_pool_stats(i2c_port_t port, struct i2c_cmd_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ESP_PLATFORM
+
+#endif  // __I2C_ESP_H
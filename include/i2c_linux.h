@@ -0,0 +1,58 @@
+/**
+ * @file i2c_linux.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Linux i2c-dev backend. A port maps onto /dev/i2c-N; a transaction goes out as a single I2C_RDWR ioctl
+ * @note adapters without I2C_FUNC_I2C (e.g. the i2c-stub kernel module) are driven through SMBus ioctls.
+ *  Only the register-oriented patterns used by libi2c are translated
+ */
+
+#ifndef __I2C_LINUX_H
+#define __I2C_LINUX_H
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+
+#include <libi2c.h>
+#include <i2c_backend.h>
+#include <linux/i2c.h>
+
+#define I2C_LINUX_FUNCS_FULL    (I2C_FUNC_I2C | I2C_FUNC_NOSTART | I2C_FUNC_SMBUS_EMUL)  // Plain I2C adapter
+#define I2C_LINUX_FUNCS_SMBUS   (I2C_FUNC_SMBUS_QUICK | I2C_FUNC_SMBUS_BYTE | I2C_FUNC_SMBUS_BYTE_DATA \
+                                    | I2C_FUNC_SMBUS_I2C_BLOCK)  // Same as i2c-stub
+
+extern const struct i2c_backend_t i2c_backend_linux;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief bind a port to /dev/i2c-adapter. By default port N opens /dev/i2c-N. Call before i2c_init
+ * @param port i2c port number
+ * @param adapter i2c-dev adapter number
+ */
+void i2c_linux_set_adapter(i2c_port_t port, int adapter);
+
+/**
+ * @brief replace the i2c-dev node of a port with a local adapter that executes the ioctls on the simulated bus
+ *  (same port number). Call before i2c_init
+ * @param port i2c port number
+ * @param funcs functionality reported by the adapter, e.g. I2C_LINUX_FUNCS_FULL or I2C_LINUX_FUNCS_SMBUS
+ * @see i2c_sim_attach
+ */
+void i2c_linux_use_sim(i2c_port_t port, unsigned long funcs);
+
+/**
+ * @brief number of ioctls issued on a port, for syscall accounting
+ * @param port i2c port number
+ * @return ioctl count since i2c_init
+ */
+uint64_t i2c_linux_ioctl_count(i2c_port_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __linux__ && !ESP_PLATFORM
+
+#endif  // __I2C_LINUX_H
@@ -0,0 +1,104 @@
+/**
+ * @file i2c_multibus.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Multi-bus context: initializes several ports at once, gives each of them an asynchronous worker pinned to
+ *  its own core and places devices on the least loaded port they answer on. Ports never share state, so sensors
+ *  split across the two controllers of the ESP32 are read in parallel
+ */
+
+#ifndef __I2C_MULTIBUS_H
+#define __I2C_MULTIBUS_H
+
+#include <libi2c.h>
+#include <i2c_async.h>
+
+#ifndef I2C_MULTIBUS_PROBE_MS
+#define I2C_MULTIBUS_PROBE_MS   (10)
+#endif
+
+/**
+ * @struct i2c_multibus_t
+ * @var i2c_multibus_t::n
+ *  number of ports
+ * @var i2c_multibus_t::ports
+ *  port numbers, in configuration order
+ * @var i2c_multibus_t::clk_hz
+ *  bus clock of each port, used to estimate the load
+ * @var i2c_multibus_t::load_pm
+ *  estimated bus utilization of each port, per mille. Above 1000 the port can't keep up
+ * @var i2c_multibus_t::placed
+ *  bitmap of the addresses placed on each port, bit (addr % 32) of placed[i][addr / 32]
+ * @var i2c_multibus_t::async
+ *  true if the ports have workers
+ * @var i2c_multibus_t::inited
+ *  number of ports, in configuration order, initialized by the context: the only ones it deinitializes
+ * @var i2c_multibus_t::started
+ *  number of workers, in configuration order, started by the context
+ */
+struct i2c_multibus_t {
+    size_t n;
+    i2c_port_t ports[I2C_NUM_MAX];
+    uint32_t clk_hz[I2C_NUM_MAX];
+    uint32_t load_pm[I2C_NUM_MAX];
+    uint32_t placed[I2C_NUM_MAX][4];
+    bool async;
+    size_t inited;
+    size_t started;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief initialize the ports and, if requested, start their workers: the i-th port's one is pinned to core i
+ *  (modulo the number of cores)
+ * @param mb context to initialize
+ * @param confs one master configuration per port, each on a different port
+ * @param n number of configurations, at most I2C_NUM_MAX
+ * @param async true to start a worker per port, see i2c_submit()
+ * @return error code. On failure, the ports and workers it had set up are torn down again, and only those
+ */
+esp_err_t i2c_multibus_init(struct i2c_multibus_t *mb, const struct i2c_bus_t *confs, size_t n, bool async);
+
+/**
+ * @brief stop the workers, after they have drained their queues, and deinitialize the context's ports (see
+ *  i2c_deinit_port). Ports initialized outside of it keep running
+ * @param mb context
+ */
+void i2c_multibus_deinit(struct i2c_multibus_t *mb);
+
+/**
+ * @brief place a device on the least loaded port where addr answers and isn't placed yet. Two chips with the same
+ *  address on different ports get a port each
+ * @param mb context
+ * @param dev device handle: port and addr are set, the other fields are left as they are
+ * @param addr 7-bit slave address
+ * @param bytes_per_s expected traffic, payload and address bytes, used to account the port's load
+ * @return ESP_ERR_NOT_FOUND if no port has a free device at addr
+ */
+esp_err_t i2c_multibus_place(struct i2c_multibus_t *mb, struct i2c_dev_handle_t *dev, i2c_addr_t addr,
+    uint32_t bytes_per_s);
+
+/**
+ * @brief forget a placed device and its load, e.g. before placing it again with a different rate
+ * @param mb context
+ * @param dev device handle, as filled by i2c_multibus_place
+ * @param bytes_per_s rate it was placed with
+ */
+void i2c_multibus_release(struct i2c_multibus_t *mb, const struct i2c_dev_handle_t *dev, uint32_t bytes_per_s);
+
+/**
+ * @brief estimated load of a port
+ * @param mb context
+ * @param port i2c port number
+ * @return bus utilization, per mille. 0 for ports not in the context
+ */
+uint32_t i2c_multibus_load(const struct i2c_multibus_t *mb, i2c_port_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_MULTIBUS_H
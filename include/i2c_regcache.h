@@ -0,0 +1,102 @@
+/**
+ * @file i2c_regcache.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Shadow register cache. Attached to a device handle, it lets i2c_read_register() serve known registers
+ *  from RAM and i2c_write_register() skip writes that wouldn't change anything. Raw writes (i2c_write_bytes,
+ *  i2c_writev, i2c_write_stream) invalidate it; i2c_transfer() and asynchronous descriptors bypass it
+ */
+
+#ifndef __I2C_REGCACHE_H
+#define __I2C_REGCACHE_H
+
+#include <libi2c.h>
+
+#define I2C_REGCACHE_REGS       (256)
+
+#define I2C_REG_VOLATILE        (0x00)  // Always on the bus: status, data, anything the device changes by itself
+#define I2C_REG_CACHED          (0x01)  // Reads from RAM once known, writes of the value already there are skipped
+#define I2C_REG_WRITE_THROUGH   (0x02)  // Reads from RAM once known, writes always on the bus (side effects, triggers)
+
+/**
+ * @struct i2c_regcache_stats_t
+ * @var i2c_regcache_stats_t::hits
+ *  i2c_read_register() calls served from RAM
+ * @var i2c_regcache_stats_t::misses
+ *  i2c_read_register() calls on non-volatile registers that had to go to the bus
+ * @var i2c_regcache_stats_t::writes
+ *  i2c_write_register() calls sent to the bus
+ * @var i2c_regcache_stats_t::suppressed
+ *  i2c_write_register() calls skipped because nothing would change
+ */
+struct i2c_regcache_stats_t {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t writes;
+    uint32_t suppressed;
+};
+
+/**
+ * @struct i2c_regcache_t
+ * @brief one per device. Protected by the port lock once attached; configure it before attaching
+ * @var i2c_regcache_t::values
+ *  shadow copy of the registers
+ * @var i2c_regcache_t::valid
+ *  bitmap of the registers whose shadow copy is known
+ * @var i2c_regcache_t::cached
+ *  bitmap of the non-volatile registers
+ * @var i2c_regcache_t::write_through
+ *  bitmap of the registers whose writes are never skipped
+ */
+struct i2c_regcache_t {
+    u8 values[I2C_REGCACHE_REGS];
+    uint32_t valid[I2C_REGCACHE_REGS / 32];
+    uint32_t cached[I2C_REGCACHE_REGS / 32];
+    uint32_t write_through[I2C_REGCACHE_REGS / 32];
+    struct i2c_regcache_stats_t stats;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief initialize a cache: every register volatile, nothing known
+ * @param cache cache to initialize
+ */
+void i2c_regcache_init(struct i2c_regcache_t *cache);
+
+/**
+ * @brief set the policy of a register range
+ * @param cache cache
+ * @param first first register
+ * @param last last register, included
+ * @param policy I2C_REG_VOLATILE, I2C_REG_CACHED or I2C_REG_WRITE_THROUGH
+ */
+void i2c_regcache_set_policy(struct i2c_regcache_t *cache, u8 first, u8 last, u8 policy);
+
+/**
+ * @brief attach a cache to a device handle. Every handle of the same device should share it
+ * @param dev pointer to dev handle structure
+ * @param cache cache, NULL to detach
+ */
+void i2c_regcache_attach(struct i2c_dev_handle_t *dev, struct i2c_regcache_t *cache);
+
+/**
+ * @brief forget every shadow copy, e.g. after a device reset
+ * @param dev pointer to dev handle structure. No-op without a cache
+ */
+void i2c_regcache_invalidate(const struct i2c_dev_handle_t *dev);
+
+/**
+ * @brief get the cache counters
+ * @param cache cache
+ * @param stats output
+ */
+void i2c_regcache_get_stats(const struct i2c_regcache_t *cache, struct i2c_regcache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_REGCACHE_H
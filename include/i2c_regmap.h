@@ -0,0 +1,201 @@
+/**
+ * @file i2c_regmap.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Slave-side register map engine. The master writes a register pointer, then reads or writes consecutive
+ *  registers from there on, like with any sensor. Reads are served straight from application memory: the map is
+ *  double buffered, the application edits one bank and publishes it while the master reads the other, so each
+ *  read sees a consistent block and nothing is copied per request
+ */
+
+#ifndef __I2C_REGMAP_H
+#define __I2C_REGMAP_H
+
+#include <libi2c.h>
+#include <i2c_sim.h>
+
+#define I2C_REGMAP_SIZE_MAX     (256)  // 8-bit register pointer
+
+#ifndef I2C_REGMAP_WRITE_MAX
+#define I2C_REGMAP_WRITE_MAX    (32)  // Consecutive bytes written by the master reported at once
+#endif
+
+#ifndef I2C_REGMAP_PRELOAD
+#define I2C_REGMAP_PRELOAD      (32)  // Bytes queued in the controller's TX buffer for the next read, on target
+#endif
+
+#ifndef I2C_REGMAP_POLL_MS
+#define I2C_REGMAP_POLL_MS      (10)  // How often the slave worker checks whether it has to stop
+#endif
+
+#ifndef I2C_REGMAP_GAP_MS
+#define I2C_REGMAP_GAP_MS       (2)  // Bus idle time that ends a master write, on target
+#endif
+
+#ifndef I2C_REGMAP_PRIO
+#define I2C_REGMAP_PRIO         (6)
+#endif
+
+struct i2c_regmap_t;
+
+/**
+ * @brief registers written by the master. Runs in the engine's context (bus or slave worker): keep it short. It can
+ *  edit and publish the map
+ * @param map register map
+ * @param reg first register written
+ * @param data bytes written, from reg on
+ * @param len number of bytes
+ * @param arg user argument
+ */
+typedef void (*i2c_regmap_write_cb_t)(struct i2c_regmap_t *map, u8 reg, const u8 *data, size_t len, void *arg);
+
+/**
+ * @struct i2c_regmap_t
+ * @brief one application thread edits and publishes, one engine serves the master. Fields up to arg can be set
+ *  after i2c_regmap_init
+ * @var i2c_regmap_t::writable
+ *  bitmap of the registers the master may write, bit (reg % 32) of writable[reg / 32]. NULL: read-only map. Writes
+ *  to other registers are NACKed (simulated bus) or dropped (target)
+ * @var i2c_regmap_t::on_write
+ *  called at the end of each run of written registers, can be NULL. Written bytes reach the banks only if the
+ *  application puts them there
+ * @var i2c_regmap_t::arg
+ *  callback argument
+ * @var i2c_regmap_t::banks
+ *  application memory, size bytes each
+ * @var i2c_regmap_t::front
+ *  index of the published bank. Atomic
+ * @var i2c_regmap_t::reading
+ *  published bank being read + 1, 0 if none. Atomic, set by the engine
+ * @var i2c_regmap_t::synced
+ *  the edit bank holds the published contents
+ * @var i2c_regmap_t::snap
+ *  bank the current read is served from
+ * @var i2c_regmap_t::ptr
+ *  register pointer, auto-incremented
+ * @var i2c_regmap_t::wreg
+ *  first register of the bytes in wbuf
+ * @var i2c_regmap_t::sim
+ *  attachable simulated device, see i2c_regmap_sim_init()
+ */
+struct i2c_regmap_t {
+    const uint32_t *writable;
+    i2c_regmap_write_cb_t on_write;
+    void *arg;
+    u8 *banks[2];
+    size_t size;
+    unsigned front;
+    unsigned reading;
+    bool synced;
+    const u8 *snap;
+    u8 ptr;
+    bool ptr_set;
+    u8 wreg;
+    size_t wlen;
+    u8 wbuf[I2C_REGMAP_WRITE_MAX];
+    struct i2c_sim_dev_t sim;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief initialize a register map over two application buffers. bank0 is published as it is, and copied to bank1
+ * @param map register map
+ * @param bank0 initial contents
+ * @param bank1 second bank, same size
+ * @param size number of registers, 1...I2C_REGMAP_SIZE_MAX. The master reads 0xff past the end
+ * @return ESP_ERR_INVALID_ARG on a bad size
+ */
+esp_err_t i2c_regmap_init(struct i2c_regmap_t *map, u8 *bank0, u8 *bank1, size_t size);
+
+/**
+ * @brief get the bank to update, holding the published contents. Waits while the master is still reading it
+ *  after the last publish, which lasts at most one transaction. Copies the published bank (size bytes) on the
+ *  first call after a publish, so partial updates are fine
+ * @param map register map
+ * @return bank to edit, then pass to i2c_regmap_publish
+ */
+u8 *i2c_regmap_edit(struct i2c_regmap_t *map);
+
+/**
+ * @brief make the edited bank the one the master reads. Reads already going on finish on the previous one
+ * @param map register map
+ */
+void i2c_regmap_publish(struct i2c_regmap_t *map);
+
+/**
+ * @brief published contents
+ * @param map register map
+ * @return published bank. Read-only, and only valid until the next i2c_regmap_edit
+ */
+const u8 *i2c_regmap_front(const struct i2c_regmap_t *map);
+
+// Engine, one bus event at a time: driven by the simulated bus or by the slave worker
+
+/**
+ * @brief (repeated) START addressed to the map. A write starts with the register pointer, a read latches the
+ *  published bank until STOP
+ * @param map register map
+ * @param rw READ_BIT or WRITE_BIT
+ */
+void i2c_regmap_start(struct i2c_regmap_t *map, u8 rw);
+
+/**
+ * @brief byte written by the master
+ * @param map register map
+ * @param data pointer or register value
+ * @return false to NACK a write to a register outside the map or not writable
+ */
+bool i2c_regmap_write(struct i2c_regmap_t *map, u8 data);
+
+/**
+ * @brief byte read by the master, from the latched bank
+ * @param map register map
+ * @return register at the pointer, 0xff past the end
+ */
+u8 i2c_regmap_read(struct i2c_regmap_t *map);
+
+/**
+ * @brief STOP: reports the written registers and releases the latched bank
+ * @param map register map
+ */
+void i2c_regmap_stop(struct i2c_regmap_t *map);
+
+/**
+ * @brief expose a map on the simulated bus
+ * @param map initialized register map
+ * @param addr 7-bit address
+ * @return pointer to the device, see i2c_sim_attach()
+ */
+struct i2c_sim_dev_t *i2c_regmap_sim_init(struct i2c_regmap_t *map, i2c_addr_t addr);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief serve a map from a port initialized in slave mode. A worker receives the pointer and the written bytes,
+ *  then queues up to I2C_REGMAP_PRELOAD registers from the pointer on for the read that follows. The ESP-IDF
+ *  slave driver reports neither START nor STOP, so a write ends when no byte has arrived for I2C_REGMAP_GAP_MS
+ *  (plus up to one RTOS tick): writes of any length are reported in order from their pointer, and the next byte
+ *  after the gap is a new pointer. The master must therefore end each write with a STOP and stay off the bus for
+ *  longer than that before the next transaction, a read (no repeated START: the clock can't be stretched) or
+ *  another write, or the two get merged
+ * @param port i2c port number, in slave mode
+ * @param map initialized register map
+ * @param core CPU to pin the worker to, -1 for no affinity
+ * @return error code
+ */
+esp_err_t i2c_regmap_serve(i2c_port_t port, struct i2c_regmap_t *map, int core);
+
+/**
+ * @brief stop serving a port. Returns within I2C_REGMAP_POLL_MS
+ * @param port i2c port number
+ */
+void i2c_regmap_serve_stop(i2c_port_t port);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_REGMAP_H
@@ -0,0 +1,146 @@
+/**
+ * @file i2c_retry.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Per-device retry policy and circuit breaker. Attached to a device handle, it makes libi2c retry failed
+ *  transactions (NACK, timeout, arbitration loss) with jittered exponential backoff, within an attempt count and a
+ *  latency budget. A device that keeps failing trips the breaker: its transactions are rejected without touching
+ *  the bus for a while, then a single probe transaction decides whether it's back
+ */
+
+#ifndef __I2C_RETRY_H
+#define __I2C_RETRY_H
+
+#include <libi2c.h>
+
+#define I2C_RETRY_ATTEMPTS      (3)
+#define I2C_RETRY_BACKOFF_MS    (1)  // First delay, doubled at each retry
+#define I2C_RETRY_BACKOFF_MAX   (8)
+#define I2C_RETRY_BUDGET_MS     (20)  // No new attempt once this much time went by since the first one
+#define I2C_RETRY_TRIP          (3)  // Consecutive failed transactions that open the breaker
+#define I2C_RETRY_OPEN_MS       (1000)  // First open period, doubled at each consecutive trip
+#define I2C_RETRY_OPEN_MAX_MS   (60000)
+
+/**
+ * @struct i2c_retry_stats_t
+ * @var i2c_retry_stats_t::retries
+ *  attempts after the first one
+ * @var i2c_retry_stats_t::exhausted
+ *  transactions that failed after the last attempt allowed by count or budget
+ * @var i2c_retry_stats_t::rejected
+ *  transactions refused while the breaker was open
+ * @var i2c_retry_stats_t::trips
+ *  times the breaker opened
+ */
+struct i2c_retry_stats_t {
+    uint32_t retries;
+    uint32_t exhausted;
+    uint32_t rejected;
+    uint32_t trips;
+};
+
+/**
+ * @struct i2c_retry_t
+ * @brief one per device. Protected by the port lock once attached; fields before failures can be tuned before
+ *  attaching. The port lock is released during backoff sleeps, so other devices keep using the bus while this one
+ *  waits; only i2c_update_bits() keeps it, to stay atomic
+ * @var i2c_retry_t::attempts
+ *  attempts per transaction, 1 disables retries
+ * @var i2c_retry_t::budget_ms
+ *  no retry starts later than this after the first attempt
+ * @var i2c_retry_t::trip
+ *  consecutive failed transactions that open the breaker, 0 disables it
+ * @var i2c_retry_t::failures
+ *  consecutive failed transactions
+ * @var i2c_retry_t::open_period_ms
+ *  length of the next open period
+ * @var i2c_retry_t::open_until_us
+ *  end of the open period, 0 while closed
+ * @var i2c_retry_t::seed
+ *  jitter generator state
+ */
+struct i2c_retry_t {
+    uint32_t attempts;
+    uint32_t backoff_ms;
+    uint32_t backoff_max_ms;
+    uint32_t budget_ms;
+    uint32_t trip;
+    uint32_t open_ms;
+    uint32_t open_max_ms;
+    uint32_t failures;
+    uint32_t open_period_ms;
+    int64_t open_until_us;
+    uint32_t seed;
+    struct i2c_retry_stats_t stats;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief default policy: I2C_RETRY_ATTEMPTS attempts within I2C_RETRY_BUDGET_MS, breaker after I2C_RETRY_TRIP
+ * @param policy policy to initialize
+ */
+void i2c_retry_init(struct i2c_retry_t *policy);
+
+/**
+ * @brief attach a policy to a device handle. Copies of the handle made afterwards share it
+ * @param dev device handle
+ * @param policy policy storage. Must stay valid while in use. NULL detaches
+ */
+void i2c_retry_attach(struct i2c_dev_handle_t *dev, struct i2c_retry_t *policy);
+
+/**
+ * @brief check whether a device is currently off the schedule
+ * @param dev device handle
+ * @return true while the breaker is open
+ */
+bool i2c_retry_is_open(const struct i2c_dev_handle_t *dev);
+
+/**
+ * @brief close the breaker and forget the failures, e.g. after power cycling the device. Implemented in libi2c.c,
+ *  under the port lock
+ * @param dev device handle
+ */
+void i2c_retry_reset(const struct i2c_dev_handle_t *dev);
+
+/**
+ * @brief snapshot of the counters
+ * @param dev device handle
+ * @param stats output, zeroed if no policy is attached
+ */
+void i2c_retry_get_stats(const struct i2c_dev_handle_t *dev, struct i2c_retry_stats_t *stats);
+
+// Used by libi2c, with the port lock held
+
+/**
+ * @brief decide whether a transaction may go to the bus
+ * @param policy policy
+ * @param now_us current time
+ * @param probe set to true for the single transaction that tests a device whose open period is over
+ * @return false if the breaker is open
+ */
+bool i2c_retry_admit(struct i2c_retry_t *policy, int64_t now_us, bool *probe);
+
+/**
+ * @brief account the outcome of a transaction, after its last attempt
+ * @param policy policy
+ * @param ok true on success
+ * @param now_us current time
+ */
+void i2c_retry_done(struct i2c_retry_t *policy, bool ok, int64_t now_us);
+
+/**
+ * @brief delay before the next attempt: half of the exponential backoff plus a random part up to the other half
+ * @param policy policy
+ * @param retry retry number, 0 for the first one
+ * @return milliseconds, at least 1
+ */
+uint32_t i2c_retry_backoff(struct i2c_retry_t *policy, uint32_t retry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_RETRY_H
@@ -0,0 +1,121 @@
+/**
+ * @file i2c_scan.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Bus scanner: probes the 7-bit address space with address-only transactions and fills a registry of
+ *  device handles, identified through chip id fingerprints when possible
+ */
+
+#ifndef __I2C_SCAN_H
+#define __I2C_SCAN_H
+
+#include <libi2c.h>
+
+#define I2C_SCAN_FIRST      (0x08)  // 0x00...0x07 and 0x78...0x7f are reserved
+#define I2C_SCAN_LAST       (0x77)
+
+#ifndef I2C_REGISTRY_MAX
+#define I2C_REGISTRY_MAX    (16)
+#endif
+
+#define I2C_FP_ADDR_ONLY    (0x01)  // No id register: the address alone is a (weak) match
+
+/**
+ * @struct i2c_fingerprint_t
+ * @brief how to recognize a chip: (addr & addr_mask) == addr_match and (register reg & mask) == value
+ * @var i2c_fingerprint_t::name
+ *  chip name
+ * @var i2c_fingerprint_t::addr_match
+ *  address, after addr_mask
+ * @var i2c_fingerprint_t::addr_mask
+ *  address bits that matter, e.g. 0x7e for chips with one strap pin on the LSB
+ * @var i2c_fingerprint_t::reg
+ *  id register
+ * @var i2c_fingerprint_t::mask
+ *  id bits that matter
+ * @var i2c_fingerprint_t::value
+ *  expected id
+ * @var i2c_fingerprint_t::flags
+ *  I2C_FP_ADDR_ONLY
+ */
+struct i2c_fingerprint_t {
+    const char *name;
+    i2c_addr_t addr_match;
+    i2c_addr_t addr_mask;
+    u8 reg;
+    u8 mask;
+    u8 value;
+    u8 flags;
+};
+
+/**
+ * @struct i2c_registry_entry_t
+ * @var i2c_registry_entry_t::dev
+ *  handle, ready to use
+ * @var i2c_registry_entry_t::fp
+ *  matching fingerprint, NULL if unknown
+ */
+struct i2c_registry_entry_t {
+    struct i2c_dev_handle_t dev;
+    const struct i2c_fingerprint_t *fp;
+};
+
+/**
+ * @struct i2c_registry_t
+ * @var i2c_registry_t::present
+ *  bitmap of the addresses that answered, bit (addr % 32) of present[addr / 32]. Compare two scans to detect hot-plug
+ * @var i2c_registry_t::found
+ *  number of addresses that answered
+ * @var i2c_registry_t::n
+ *  number of entries
+ * @var i2c_registry_t::devs
+ *  one entry per device, in address order. Devices past I2C_REGISTRY_MAX only show up in present
+ */
+struct i2c_registry_t {
+    uint32_t present[4];
+    size_t found;
+    size_t n;
+    struct i2c_registry_entry_t devs[I2C_REGISTRY_MAX];
+};
+
+/**
+ * @brief built-in fingerprints, terminated by an entry with a NULL name
+ */
+extern const struct i2c_fingerprint_t i2c_fingerprints[];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief scan a port: probe every non-reserved address with a timeout of I2C_PROBE_TIMEOUT_MS, then match the
+ *  devices that answered against the fingerprints
+ * @param port i2c port number. Must be initialized as master
+ * @param registry output
+ * @param fps fingerprints, terminated by an entry with a NULL name. NULL for i2c_fingerprints
+ * @return error code if the bus failed (e.g. stuck, not initialized). A NACK just means no device
+ */
+esp_err_t i2c_scan(i2c_port_t port, struct i2c_registry_t *registry, const struct i2c_fingerprint_t *fps);
+
+/**
+ * @brief find a device by chip name
+ * @param registry scan result
+ * @param name chip name, as in the fingerprint
+ * @param nth 0 for the first match, 1 for the second...
+ * @return handle, NULL if not found
+ */
+const struct i2c_dev_handle_t *i2c_registry_find(const struct i2c_registry_t *registry, const char *name, size_t nth);
+
+/**
+ * @brief check whether an address answered
+ * @param registry scan result
+ * @param addr 7-bit address
+ * @return true if present
+ */
+bool i2c_registry_present(const struct i2c_registry_t *registry, i2c_addr_t addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_SCAN_H
@@ -0,0 +1,172 @@
+/**
+ * @file i2c_sim.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief In-process simulated I2C bus. Device models attach to a port by address and are driven byte by byte
+ */
+
+#ifndef __I2C_SIM_H
+#define __I2C_SIM_H
+
+#include <libi2c.h>
+#include <i2c_backend.h>
+
+#define I2C_SIM_REGS    (256)
+
+struct i2c_sim_dev_t;
+
+/**
+ * @struct i2c_sim_ops_t
+ * @brief device model callbacks. Any of them can be NULL
+ * @var i2c_sim_ops_t::start
+ *  (repeated) START followed by the device's address. Return false to NACK the address
+ * @var i2c_sim_ops_t::write
+ *  byte written by the master. Return false to NACK it
+ * @var i2c_sim_ops_t::read
+ *  byte requested by the master. ack tells whether the master will ACK it (more bytes follow)
+ * @var i2c_sim_ops_t::stop
+ *  STOP condition
+ */
+struct i2c_sim_ops_t {
+    bool (*start)(struct i2c_sim_dev_t *dev, u8 rw);
+    bool (*write)(struct i2c_sim_dev_t *dev, u8 data);
+    u8 (*read)(struct i2c_sim_dev_t *dev, bool ack);
+    void (*stop)(struct i2c_sim_dev_t *dev);
+};
+
+/**
+ * @struct i2c_sim_dev_t
+ * @var i2c_sim_dev_t::addr
+ *  7-bit address the model answers to
+ * @var i2c_sim_dev_t::ops
+ *  model callbacks
+ * @var i2c_sim_dev_t::ctx
+ *  model private data
+ * @var i2c_sim_dev_t::next
+ *  used by the bus. Do not touch
+ */
+struct i2c_sim_dev_t {
+    i2c_addr_t addr;
+    const struct i2c_sim_ops_t *ops;
+    void *ctx;
+    struct i2c_sim_dev_t *next;
+};
+
+/**
+ * @struct i2c_sim_regs_t
+ * @brief generic register file model: the first written byte sets the register pointer, following bytes are
+ *  stored from there on, reads return registers from the pointer on. The pointer auto-increments
+ * @var i2c_sim_regs_t::dev
+ *  attachable device, see i2c_sim_regs_init()
+ * @var i2c_sim_regs_t::regs
+ *  register contents
+ * @var i2c_sim_regs_t::ptr
+ *  register pointer
+ * @var i2c_sim_regs_t::on_write
+ *  optional hook called after a register has been written
+ * @var i2c_sim_regs_t::on_read
+ *  optional hook called before a register is read, e.g. to refresh it
+ */
+struct i2c_sim_regs_t {
+    struct i2c_sim_dev_t dev;
+    u8 regs[I2C_SIM_REGS];
+    u8 ptr;
+    bool ptr_set;
+    void (*on_write)(struct i2c_sim_regs_t *model, u8 reg, u8 data);
+    void (*on_read)(struct i2c_sim_regs_t *model, u8 reg);
+};
+
+/**
+ * @struct i2c_sim_stats_t
+ * @var i2c_sim_stats_t::transactions
+ *  START...STOP sequences
+ * @var i2c_sim_stats_t::bytes
+ *  bytes on the wire, address bytes included
+ * @var i2c_sim_stats_t::nacks
+ *  transactions aborted because of a NACK
+ * @var i2c_sim_stats_t::bus_time_ns
+ *  time the transactions would take on a real bus, given the configured clock
+ */
+struct i2c_sim_stats_t {
+    uint64_t transactions;
+    uint64_t bytes;
+    uint64_t nacks;
+    uint64_t bus_time_ns;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief attach a device model to a simulated port. The port doesn't need to be initialized yet
+ * @param port i2c port number
+ * @param dev device model. Must stay valid until detached
+ */
+void i2c_sim_attach(i2c_port_t port, struct i2c_sim_dev_t *dev);
+
+/**
+ * @brief detach a device model
+ * @param port i2c port number
+ * @param dev device model
+ */
+void i2c_sim_detach(i2c_port_t port, struct i2c_sim_dev_t *dev);
+
+/**
+ * @brief initialize a register file model
+ * @param model model to initialize. Registers are zeroed
+ * @param addr 7-bit address
+ * @return pointer to the attachable device
+ */
+struct i2c_sim_dev_t *i2c_sim_regs_init(struct i2c_sim_regs_t *model, i2c_addr_t addr);
+
+/**
+ * @brief limit the payload of a transaction, to mimic a constrained adapter. The first byte of a leading write
+ *  (register address or control byte) doesn't count; longer transactions fail with ESP_ERR_INVALID_SIZE and never reach the bus
+ * @param port i2c port number
+ * @param max largest payload per transaction, 0 for no limit (default)
+ */
+void i2c_sim_set_max_transfer(i2c_port_t port, size_t max);
+
+/**
+ * @brief mimic a bus that doesn't tolerate fast clocks (long cables, weak pull-ups): above hz, one transaction in
+ *  four is NACKed
+ * @param port i2c port number
+ * @param hz highest reliable clock, 0 for no limit (default)
+ */
+void i2c_sim_set_clock_limit(i2c_port_t port, uint32_t hz);
+
+/**
+ * @brief mimic a slave holding SDA low (e.g. reset in the middle of a read): every transaction times out until
+ *  recovery clocks out the given number of SCL pulses. Recovery gives at most 9 per attempt
+ * @param port i2c port number
+ * @param pulses pulses needed to release SDA, 0 to release it now
+ */
+void i2c_sim_hold_sda(i2c_port_t port, unsigned pulses);
+
+/**
+ * @brief make transactions take as long as they would on a real bus, given the clock. The calling thread sleeps,
+ *  with the port lock held, so ports run in parallel and devices sharing a port don't
+ * @param port i2c port number
+ * @param realtime true to enable, false for instant transactions (default)
+ */
+void i2c_sim_set_realtime(i2c_port_t port, bool realtime);
+
+/**
+ * @brief get the traffic counters of a simulated port
+ * @param port i2c port number
+ * @param stats output
+ */
+void i2c_sim_get_stats(i2c_port_t port, struct i2c_sim_stats_t *stats);
+
+/**
+ * @brief reset the traffic counters of a simulated port
+ * @param port i2c port number
+ */
+void i2c_sim_reset_stats(i2c_port_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_SIM_H
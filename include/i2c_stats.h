@@ -0,0 +1,139 @@
+/**
+ * @file i2c_stats.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Per-port and per-device transaction statistics: counts, bytes, failures by kind and a latency histogram.
+ *  Every transaction libi2c hands to a backend is timed and recorded, with relaxed atomic increments. Build with
+ *  I2C_STATS=0 to compile all of it out
+ */
+
+#ifndef __I2C_STATS_H
+#define __I2C_STATS_H
+
+#include <libi2c.h>
+#include <i2c_backend.h>
+#include <string.h>
+
+#ifndef I2C_STATS
+#define I2C_STATS               (1)  // Must be the same for the whole build
+#endif
+
+#ifndef I2C_STATS_DEVICES
+#define I2C_STATS_DEVICES       (8)  // Device slots per port
+#endif
+
+#define I2C_STATS_BUCKETS       (16)  // Bucket 0: < 1 us, bucket k: [2^(k-1), 2^k) us, last one: everything above
+#define I2C_STATS_PORT_ONLY     I2C_ADDR_NONE  // Address of transactions recorded per port only, e.g. probes
+
+/**
+ * @struct i2c_stats_t
+ * @brief 32-bit counters: they wrap, compare snapshots by difference
+ * @var i2c_stats_t::transactions
+ *  transactions handed to the backend, failed ones included
+ * @var i2c_stats_t::bytes
+ *  payload bytes of the successful transactions, both directions
+ * @var i2c_stats_t::nacks
+ *  transactions ended by a NACK (ESP_FAIL)
+ * @var i2c_stats_t::timeouts
+ *  transactions ended by ESP_ERR_TIMEOUT
+ * @var i2c_stats_t::arb_lost
+ *  transactions ended by I2C_ERR_ARB_LOST
+ * @var i2c_stats_t::errors
+ *  transactions ended by any other error
+ * @var i2c_stats_t::recoveries
+ *  bus recoveries, counted on the device whose transaction timed out
+ * @var i2c_stats_t::latency
+ *  time spent in the backend, log2 microsecond buckets
+ */
+struct i2c_stats_t {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t arb_lost;
+    uint32_t errors;
+    uint32_t recoveries;
+    uint32_t latency[I2C_STATS_BUCKETS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if I2C_STATS
+
+/**
+ * @brief account a transaction. Called by libi2c with the port lock held
+ * @param port i2c port number
+ * @param addr slave address, I2C_STATS_PORT_ONLY to skip the device counters
+ * @param msgs transaction segments
+ * @param n number of segments
+ * @param ret backend's return code
+ * @param us time spent in the backend
+ */
+void i2c_stats_record(i2c_port_t port, i2c_addr_t addr, const struct i2c_msg_t *msgs, size_t n, esp_err_t ret, uint32_t us);
+
+/**
+ * @brief account a bus recovery. Called by libi2c with the port lock held
+ * @param port i2c port number
+ * @param addr slave whose transaction timed out, I2C_STATS_PORT_ONLY if none
+ */
+void i2c_stats_record_recovery(i2c_port_t port, i2c_addr_t addr);
+
+/**
+ * @brief snapshot of a port's counters. Lock-free, each counter is read atomically but not the set as a whole
+ * @param port i2c port number
+ * @param out output
+ * @return ESP_ERR_INVALID_ARG on a bad port
+ */
+esp_err_t i2c_stats_get_port(i2c_port_t port, struct i2c_stats_t *out);
+
+/**
+ * @brief snapshot of a device's counters. A device gets a slot on its first transaction, while any of the
+ *  I2C_STATS_DEVICES slots of its port is free; later devices are only counted per port
+ * @param dev device handle
+ * @param out output
+ * @return ESP_ERR_NOT_FOUND if the device has no slot
+ */
+esp_err_t i2c_stats_get_dev(const struct i2c_dev_handle_t *dev, struct i2c_stats_t *out);
+
+/**
+ * @brief zero the counters of a port and of its devices. Slots stay assigned
+ * @param port i2c port number
+ */
+void i2c_stats_reset(i2c_port_t port);
+
+#else
+
+static inline esp_err_t i2c_stats_get_port(i2c_port_t port, struct i2c_stats_t *out) {
+    (void) port;
+    memset(out, 0, sizeof(*out));
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t i2c_stats_get_dev(const struct i2c_dev_handle_t *dev, struct i2c_stats_t *out) {
+    (void) dev;
+    memset(out, 0, sizeof(*out));
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline void i2c_stats_reset(i2c_port_t port) {
+    (void) port;
+}
+
+#endif  // I2C_STATS
+
+/**
+ * @brief latency percentile from a histogram
+ * @param stats snapshot
+ * @param pct percentile, 0...100
+ * @return upper bound of the bucket holding the percentile, in microseconds. 0 if there are no transactions,
+ *  UINT32_MAX if it falls in the last bucket
+ */
+uint32_t i2c_stats_percentile(const struct i2c_stats_t *stats, unsigned pct);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_STATS_H
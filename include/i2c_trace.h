@@ -0,0 +1,191 @@
+/**
+ * @file i2c_trace.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Binary bus trace. Once a ring is attached to a port, libi2c appends a record per transaction: timestamp,
+ *  duration, address, segments with their payload and result. The ring overwrites its oldest records and is dumped
+ *  on demand into a flat buffer, which can be written to a file and replayed on the host (bench/i2c_replay.c)
+ *
+ *  Dump layout, little endian:
+ *  - header: "I2CT", version, payload cap, 2 reserved bytes
+ *  - records: u16 record size, u32 timestamp (us), u16 duration (us, saturated), u8 port, u8 address, u8 result
+ *    (I2C_TRACE_OK...), u8 segment count, then per segment u8 flags (I2C_MSG_*), u8 captured bytes, u16 length,
+ *    then the captured payloads in segment order
+ */
+
+#ifndef __I2C_TRACE_H
+#define __I2C_TRACE_H
+
+#include <libi2c.h>
+#include <i2c_backend.h>
+
+#ifndef I2C_TRACE
+#define I2C_TRACE               (1)  // Must be the same for the whole build. Tracing is off until a ring is attached
+#endif
+
+#ifndef I2C_TRACE_PAYLOAD
+#define I2C_TRACE_PAYLOAD       (32)  // Bytes captured per segment, at most 255. Longer segments are truncated
+#endif
+
+#define I2C_TRACE_VERSION       (1)
+#define I2C_TRACE_HDR_LEN       (8)
+#define I2C_TRACE_REC_LEN       (12)
+#define I2C_TRACE_SEG_LEN       (4)
+#define I2C_TRACE_SEGS          (I2C_IOV_MAX)  // Segments recorded per transaction, the rest are dropped
+
+#define I2C_TRACE_OK            (0)
+#define I2C_TRACE_NACK          (1)
+#define I2C_TRACE_TIMEOUT       (2)
+#define I2C_TRACE_ARB_LOST      (3)
+#define I2C_TRACE_ERROR         (4)
+
+/**
+ * @struct i2c_trace_t
+ * @brief byte ring of variable-length records. Written under the port lock; stop the trace before dumping it
+ * @var i2c_trace_t::buf
+ *  storage, a power of two bytes
+ * @var i2c_trace_t::head
+ *  free-running write offset
+ * @var i2c_trace_t::tail
+ *  free-running offset of the oldest record
+ * @var i2c_trace_t::records
+ *  records in the ring
+ * @var i2c_trace_t::dropped
+ *  records overwritten or too large for the ring
+ */
+struct i2c_trace_t {
+    u8 *buf;
+    size_t mask;
+    size_t head;
+    size_t tail;
+    uint32_t records;
+    uint32_t dropped;
+};
+
+/**
+ * @struct i2c_trace_seg_t
+ * @var i2c_trace_seg_t::flags
+ *  I2C_MSG_READ or I2C_MSG_WRITE, optionally or-ed with I2C_MSG_NOSTART
+ * @var i2c_trace_seg_t::captured
+ *  bytes of data available: the first ones sent, or received if the transaction succeeded
+ * @var i2c_trace_seg_t::len
+ *  original segment length
+ * @var i2c_trace_seg_t::data
+ *  captured bytes, inside the parsed buffer
+ */
+struct i2c_trace_seg_t {
+    u8 flags;
+    u8 captured;
+    uint16_t len;
+    const u8 *data;
+};
+
+/**
+ * @struct i2c_trace_rec_t
+ * @brief a parsed record
+ */
+struct i2c_trace_rec_t {
+    uint32_t ts_us;
+    uint16_t dur_us;
+    u8 port;
+    i2c_addr_t addr;
+    u8 result;
+    u8 n;
+    struct i2c_trace_seg_t seg[I2C_TRACE_SEGS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief prepare a ring
+ * @param trace ring
+ * @param buf storage. Must stay valid while in use
+ * @param size storage size, a power of two
+ * @return ESP_ERR_INVALID_SIZE if size is not a power of two or can't hold a record
+ */
+esp_err_t i2c_trace_init(struct i2c_trace_t *trace, u8 *buf, size_t size);
+
+/**
+ * @brief start tracing a port's transactions. Implemented in libi2c.c, under the port lock
+ * @param port initialized i2c port number
+ * @param trace ring, one per port
+ * @return ESP_ERR_INVALID_STATE if the port is not initialized, ESP_ERR_NOT_SUPPORTED if built with I2C_TRACE=0
+ */
+esp_err_t i2c_trace_start(i2c_port_t port, struct i2c_trace_t *trace);
+
+/**
+ * @brief stop tracing a port. The ring keeps its records
+ * @param port i2c port number
+ */
+void i2c_trace_stop(i2c_port_t port);
+
+/**
+ * @brief append a transaction. Called by libi2c with the port lock held
+ * @param trace ring
+ * @param port i2c port number
+ * @param addr slave address
+ * @param msgs transaction segments, after the transfer
+ * @param n number of segments
+ * @param ret backend's return code
+ * @param ts_us start time
+ * @param dur_us time spent in the backend
+ */
+void i2c_trace_record(struct i2c_trace_t *trace, i2c_port_t port, i2c_addr_t addr, const struct i2c_msg_t *msgs, size_t n,
+        esp_err_t ret, uint32_t ts_us, uint32_t dur_us);
+
+/**
+ * @brief bytes needed by i2c_trace_dump
+ * @param trace ring
+ * @return header plus records
+ */
+size_t i2c_trace_dump_size(const struct i2c_trace_t *trace);
+
+/**
+ * @brief copy header and records, oldest first, into a flat buffer
+ * @param trace ring, stopped
+ * @param out output
+ * @param size output capacity
+ * @return bytes written, 0 if out is too small
+ */
+size_t i2c_trace_dump(const struct i2c_trace_t *trace, u8 *out, size_t size);
+
+/**
+ * @brief check a dump's header
+ * @param data dump
+ * @param len dump length
+ * @return offset of the first record, 0 if the header is not valid
+ */
+size_t i2c_trace_first(const u8 *data, size_t len);
+
+/**
+ * @brief parse the record at *off and move past it
+ * @param data dump
+ * @param len dump length
+ * @param off record offset, from i2c_trace_first() or a previous call
+ * @param rec output, points into data
+ * @return false at the end of the dump or on a malformed record, e.g. more bytes captured than the segment
+ *  length or the payload cap in the header
+ */
+bool i2c_trace_next(const u8 *data, size_t len, size_t *off, struct i2c_trace_rec_t *rec);
+
+/**
+ * @brief error code of a result class
+ * @param result I2C_TRACE_OK...
+ * @return ESP_OK, ESP_FAIL, ESP_ERR_TIMEOUT, I2C_ERR_ARB_LOST or ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t i2c_trace_result_err(u8 result);
+
+/**
+ * @brief result class of an error code
+ * @param ret error code
+ * @return I2C_TRACE_OK...
+ */
+u8 i2c_trace_err_result(esp_err_t ret);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __I2C_TRACE_H
@@ -8,9 +8,14 @@
 #ifndef __LIBI2C_H
 #define __LIBI2C_H
 
+#ifdef ESP_PLATFORM
 #include <driver/i2c.h>
+#else
+#include <libi2c_host.h>
+#endif
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #define ACK_CHECK_EN    (0x01)
 #define ACK_CHECK_DIS   (0x00)
@@ -27,9 +32,26 @@
 #define PORT_0           I2C_NUM_0
 #define PORT_1           I2C_NUM_1
 
+#ifndef I2C_DEFAULT_TIMEOUT_MS
+#define I2C_DEFAULT_TIMEOUT_MS  (1000)  // Devices with timeout_ms = 0
+#endif
+#define I2C_PROBE_TIMEOUT_MS    (5)  // An address-only transaction takes ~30 us at 400 kHz
+
+#define I2C_ADDR_NONE           (0xff)  // Not a 7-bit address
+
+#define I2C_ERR_BASE            (0x1e000)  // libi2c error codes, past ESP-IDF's component ranges
+#define I2C_ERR_ARB_LOST        (I2C_ERR_BASE + 1)  // Another master won the bus
+#define I2C_ERR_CIRCUIT_OPEN    (I2C_ERR_BASE + 2)  // Device off the schedule after repeated failures, see i2c_retry.h
+
+#define I2C_IOV_MAX             (8)  // Segments per i2c_writev call
+
+#ifndef I2C_STREAM_CHUNK
+#define I2C_STREAM_CHUNK        (128)  // i2c_write_stream staging buffer, on the caller's stack
+#endif
+
 #ifndef __cplusplus
 #define noop            (void)0
-#define assert(x)       ((!x || x <= 0) ? exit(1) : noop)
+#define assert(x)       ((!(x) || (x) <= 0) ? exit(1) : noop)
 #endif
 
 
@@ -37,6 +59,10 @@ typedef uint8_t u8;
 typedef u8 i2c_buf_size_t;
 typedef u8 i2c_addr_t;
 
+struct i2c_backend_t;
+struct i2c_regcache_t;
+struct i2c_retry_t;
+
 /**
  * @struct i2c_bus_t
  * @var i2c_config::conf
@@ -47,15 +73,19 @@ typedef u8 i2c_addr_t;
  *  receive buffer size. Leave 0 for master. It doesn't need a buffer
  * @var i2c_config_t::tx
  *  transmission buffer size. Leave 0 for master. It doesn't need a buffer
+ * @var i2c_bus_t::backend
+ *  transport driving this port. Leave NULL for the platform default (ESP-IDF on target, simulated bus on host)
  * @see i2c_config_t
  * @see i2c_port_t
  * @see i2c_buf_size_t
+ * @see i2c_backend_t
  */
 struct i2c_bus_t {
     i2c_config_t conf;
     i2c_port_t port;
     i2c_buf_size_t rx;
     i2c_buf_size_t tx;
+    const struct i2c_backend_t *backend;
 };
 
 /**
@@ -101,12 +131,61 @@ struct i2c_bus_t {
  *  i2c bus number to which the slave is connected
  * @var i2c_dev_handle_t::addr
  *  slave address (7-bit)
+ * @var i2c_dev_handle_t::cache
+ *  optional shadow register cache, see i2c_regcache.h. NULL by default
+ * @var i2c_dev_handle_t::retry
+ *  optional retry policy and circuit breaker, see i2c_retry.h. NULL by default: a single attempt
+ * @var i2c_dev_handle_t::timeout_ms
+ *  budget of each transaction with this device, 0 for I2C_DEFAULT_TIMEOUT_MS. Handles are values: for a one-off
+ *  budget, call with a copy that has a different timeout
  * @see i2c_port_t
  * @see i2c_addr_t
  */
 struct i2c_dev_handle_t {
     i2c_port_t port;
     i2c_addr_t addr;
+    struct i2c_regcache_t *cache;
+    struct i2c_retry_t *retry;
+    uint32_t timeout_ms;
+};
+
+/**
+ * @struct i2c_recovery_event_t
+ * @brief report of a bus recovery, see i2c_set_recovery_callback()
+ * @var i2c_recovery_event_t::addr
+ *  slave whose transaction timed out, I2C_ADDR_NONE for i2c_bus_recover() calls
+ * @var i2c_recovery_event_t::result
+ *  ESP_OK if SDA is free afterwards, ESP_FAIL if a slave still holds it, error code otherwise
+ * @var i2c_recovery_event_t::pulses
+ *  SCL pulses clocked out before SDA was released
+ * @var i2c_recovery_event_t::duration_us
+ *  time the port spent recovering
+ */
+struct i2c_recovery_event_t {
+    i2c_port_t port;
+    i2c_addr_t addr;
+    esp_err_t result;
+    unsigned pulses;
+    uint32_t duration_us;
+};
+
+/**
+ * @brief recovery observer. Called with the port lock held: it must not start transactions on that port
+ * @param ev what happened
+ * @param arg user argument
+ */
+typedef void (*i2c_recovery_cb_t)(const struct i2c_recovery_event_t *ev, void *arg);
+
+/**
+ * @struct i2c_iovec_t
+ * @var i2c_iovec_t::base
+ *  segment start
+ * @var i2c_iovec_t::len
+ *  segment length
+ */
+struct i2c_iovec_t {
+    const void *base;
+    size_t len;
 };
 
 #ifdef __cplusplus
@@ -114,36 +193,41 @@ extern "C" {
 #endif
 
 /**
- * @brief initialize i2c communication
- * @param conf configuration struct
- * @return void
+ * @brief initialize i2c communication on conf->port. Ports are independent: initialize both to drive them at once
+ * @param conf configuration struct. Not referenced after the call
+ * @return backend's error code. The port stays unusable on failure
  */
-void i2c_init(const struct i2c_bus_t *conf);
+esp_err_t i2c_init(const struct i2c_bus_t *conf);
 
 /**
  * @brief read a series of len bytes and save them into an array. Only for master.
+ *  Reads longer than the backend's maximum transaction are split into consecutive transactions
  * @param dev pointer to dev handle structure
  * @param size number of bytes to read. Length of data array
  * @param data pointer to an array of uint8_t, where the data will be stored
  * @return error code
  */
-esp_err_t i2c_read_bytes(const struct i2c_dev_handle_t *dev, u8 *data, u8 size);
+esp_err_t i2c_read_bytes(const struct i2c_dev_handle_t *dev, u8 *data, size_t size);
 
 /**
- * @brief read one byte and return it
+ * @brief read one byte
  * @param dev pointer to dev handle structure
- * @return the read byte
+ * @param data output, left untouched on failure
+ * @return error code
  */
-u8 i2c_read_byte(const struct i2c_dev_handle_t *dev);
+esp_err_t i2c_read_byte(const struct i2c_dev_handle_t *dev, u8 *data);
 
 /**
  * @brief send a series of bytes to the slave
+ *  Writes longer than the backend's maximum transaction are split into consecutive transactions. If a register has
+ *  been selected, every chunk is prefixed with it (e.g. the data control byte of a display). Invalidates the register
+ *  cache, if any: use i2c_write_register() to keep it
  * @param dev pointer to dev handle structure
  * @param size data's length
  * @param data array of uint8_t
  * @return void
  */
-esp_err_t i2c_write_bytes(const struct i2c_dev_handle_t *dev, const u8 *data, u8 size);
+esp_err_t i2c_write_bytes(const struct i2c_dev_handle_t *dev, const u8 *data, size_t size);
 
 /**
  * @brief send a byte to the slave
@@ -162,7 +246,110 @@ esp_err_t i2c_write_byte(const struct i2c_dev_handle_t *dev, u8 data);
 void i2c_select_register(const struct i2c_dev_handle_t *dev, u8 reg, u8 rw);
 
 /**
- * @brief delete i2c driver and free memory
+ * @brief read a series of registers in a single transaction: register write, repeated START, burst read. Only for master.
+ *  Reads longer than the backend's maximum transaction are split, each chunk starting at reg + offset.
+ *  With a register cache attached, a range of known non-volatile registers is served from RAM
+ * @param dev pointer to dev handle structure
+ * @param reg first register's address on the slave
+ * @param data pointer to an array of uint8_t, where the data will be stored
+ * @param size number of bytes to read. Length of data array
+ * @return error code
+ */
+esp_err_t i2c_read_register(const struct i2c_dev_handle_t *dev, u8 reg, u8 *data, size_t size);
+
+/**
+ * @brief write a series of registers in a single transaction: register address followed by the data. Only for master.
+ *  With a register cache attached, registers already holding the given values are not sent (the write is trimmed
+ *  to the changed span, or skipped), unless they are I2C_REG_WRITE_THROUGH
+ * @param dev pointer to dev handle structure
+ * @param reg first register's address on the slave
+ * @param data values
+ * @param size number of registers
+ * @return error code
+ */
+esp_err_t i2c_write_register(const struct i2c_dev_handle_t *dev, u8 reg, const u8 *data, size_t size);
+
+/**
+ * @brief read-modify-write of a register field: register = (register & ~mask) | (value & mask). Read and write happen
+ *  under the port lock, with no other transaction in between. With a register cache attached and the register known
+ *  the read is skipped; if the register wouldn't change the write is skipped (unless I2C_REG_WRITE_THROUGH).
+ *  Retry backoffs (see i2c_retry.h) keep the port for the whole operation
+ * @param dev pointer to dev handle structure
+ * @param reg register's address on the slave
+ * @param mask bits to change
+ * @param value new bits, only those in mask are used
+ * @return error code
+ */
+esp_err_t i2c_update_bits(const struct i2c_dev_handle_t *dev, u8 reg, u8 mask, u8 value);
+
+/**
+ * @brief gather write: send every segment, in order, inside a single START...STOP transaction. Segments are not copied
+ * @param dev pointer to dev handle structure
+ * @param iov segments, e.g. register address or control byte followed by the payload
+ * @param n number of segments, at most I2C_IOV_MAX
+ * @return error code. ESP_ERR_INVALID_SIZE if the total exceeds the backend's maximum transaction, not counting a
+ *  1-byte first segment followed by others (the register address or control byte)
+ */
+esp_err_t i2c_writev(const struct i2c_dev_handle_t *dev, const struct i2c_iovec_t *iov, size_t n);
+
+/**
+ * @brief data source for i2c_write_stream
+ * @param buf buffer to fill
+ * @param size buffer capacity
+ * @param arg user argument
+ * @return number of bytes written into buf, 0 at the end of the stream
+ */
+typedef size_t (*i2c_producer_t)(u8 *buf, size_t size, void *arg);
+
+/**
+ * @brief send a payload of any length, pulled chunk by chunk from a producer. Every chunk is a transaction made of
+ *  prefix followed by the chunk, so the payload never needs to be staged in one contiguous buffer
+ * @param dev pointer to dev handle structure
+ * @param prefix bytes sent at the beginning of every chunk (e.g. register address or control byte), can be NULL
+ * @param prefix_len prefix's length
+ * @param producer data source, asked for at most I2C_STREAM_CHUNK bytes at a time, fewer if the backend's maximum
+ *  transaction is smaller (a prefix longer than 1 byte takes its extra bytes from the chunk)
+ * @param arg producer's argument
+ * @return error code. ESP_ERR_INVALID_SIZE if the producer returns more than it was asked for (nothing of that
+ *  chunk is sent) or the prefix alone exceeds the backend's maximum
+ */
+esp_err_t i2c_write_stream(const struct i2c_dev_handle_t *dev, const u8 *prefix, size_t prefix_len,
+    i2c_producer_t producer, void *arg);
+
+/**
+ * @brief check whether a slave answers: address-only write transaction (START, address, STOP), no data
+ * @param dev pointer to dev handle structure
+ * @param timeout_ms transaction timeout, e.g. I2C_PROBE_TIMEOUT_MS
+ * @return ESP_OK if the address has been ACKed, ESP_FAIL on NACK, error code otherwise
+ */
+esp_err_t i2c_probe(const struct i2c_dev_handle_t *dev, uint32_t timeout_ms);
+
+/**
+ * @brief free a stuck bus: reset the controller, clock SCL until the slave holding SDA lets go (at most 9 pulses),
+ *  generate a STOP. libi2c does it by itself after every timed out transaction, if the backend supports it
+ * @param port initialized i2c port number
+ * @return ESP_OK if the bus is free, ESP_FAIL if SDA is still held low, ESP_ERR_NOT_SUPPORTED if the backend can't
+ */
+esp_err_t i2c_bus_recover(i2c_port_t port);
+
+/**
+ * @brief get notified of every recovery of a port, e.g. to log it or to power cycle a sensor that keeps hanging.
+ *  Can be called before i2c_init, and survives it
+ * @param port i2c port number
+ * @param cb observer, NULL to remove it
+ * @param arg observer's argument
+ */
+void i2c_set_recovery_callback(i2c_port_t port, i2c_recovery_cb_t cb, void *arg);
+
+/**
+ * @brief delete i2c driver and free memory of a single port. The other ports are left as they are
+ * @param port i2c port number
+ * @return ESP_ERR_INVALID_STATE if the port isn't initialized
+ */
+esp_err_t i2c_deinit_port(i2c_port_t port);
+
+/**
+ * @brief delete i2c driver and free memory, for every initialized port
  */
 void i2c_deinit(void);
 
@@ -170,4 +357,4 @@ void i2c_deinit(void);
 }
 #endif
 
-#endif  // __LIBI2C_H
\ No newline at end of file
+#endif  // __LIBI2C_H
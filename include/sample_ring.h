@@ -0,0 +1,131 @@
+/**
+ * @file sample_ring.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Lock-free single-producer/multi-consumer ring of timestamped samples. The producer never waits: a consumer
+ *  that falls more than SAMPLE_RING_SIZE samples behind skips the overwritten ones. Every consumer sees every
+ *  sample it keeps up with, at its own rate, and can read them decimated to min/max/mean
+ */
+
+#ifndef __SAMPLE_RING_H
+#define __SAMPLE_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef SAMPLE_RING_SIZE
+#define SAMPLE_RING_SIZE    (64)  // Power of 2
+#endif
+
+#ifndef SAMPLE_CHANNELS
+#define SAMPLE_CHANNELS     (2)  // E.g. temperature and pressure
+#endif
+
+/**
+ * @struct sample_t
+ * @var sample_t::ts_us
+ *  timestamp in microseconds, e.g. esp_timer_get_time()
+ * @var sample_t::value
+ *  compensated values, one per channel
+ */
+struct sample_t {
+    int64_t ts_us;
+    float value[SAMPLE_CHANNELS];
+};
+
+/**
+ * @struct sample_agg_t
+ * @brief aggregate of consecutive samples
+ * @var sample_agg_t::count
+ *  number of samples
+ * @var sample_agg_t::first_us
+ *  timestamp of the first sample
+ * @var sample_agg_t::last_us
+ *  timestamp of the last sample
+ */
+struct sample_agg_t {
+    size_t count;
+    int64_t first_us;
+    int64_t last_us;
+    float min[SAMPLE_CHANNELS];
+    float max[SAMPLE_CHANNELS];
+    float mean[SAMPLE_CHANNELS];
+};
+
+/**
+ * @struct sample_ring_t
+ * @brief zero-initialize (static storage) or sample_ring_init() before use. Fields are updated atomically
+ * @var sample_ring_t::head
+ *  number of samples pushed so far
+ * @var sample_ring_t::seq
+ *  per slot: index of the sample it holds, plus one. Changed while the slot is being written
+ */
+struct sample_ring_t {
+    uint32_t head;
+    uint32_t seq[SAMPLE_RING_SIZE];
+    struct sample_t slots[SAMPLE_RING_SIZE];
+};
+
+/**
+ * @struct sample_reader_t
+ * @brief consumer cursor. One per consumer, owned by it
+ * @var sample_reader_t::next
+ *  index of the next sample to read
+ * @var sample_reader_t::lost
+ *  samples overwritten before this consumer could read them
+ */
+struct sample_reader_t {
+    uint32_t next;
+    uint32_t lost;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief empty the ring. Not safe while the producer or consumers are running
+ * @param ring ring buffer
+ */
+void sample_ring_init(struct sample_ring_t *ring);
+
+/**
+ * @brief publish a sample. Producer only. Wait-free
+ * @param ring ring buffer
+ * @param sample sample to copy
+ */
+void sample_ring_push(struct sample_ring_t *ring, const struct sample_t *sample);
+
+/**
+ * @brief register a consumer. It will read samples pushed from now on
+ * @param ring ring buffer
+ * @param reader cursor to initialize
+ */
+void sample_ring_reader_init(struct sample_ring_t *ring, struct sample_reader_t *reader);
+
+/**
+ * @brief read the next sample. Never blocks the producer, never waits for it: a slot being overwritten counts as lost
+ * @param ring ring buffer
+ * @param reader consumer cursor
+ * @param sample output
+ * @return false if there are no new samples
+ */
+bool sample_ring_read(struct sample_ring_t *ring, struct sample_reader_t *reader, struct sample_t *sample);
+
+/**
+ * @brief read up to max new samples and reduce them to min/max/mean, e.g. once per display refresh
+ * @param ring ring buffer
+ * @param reader consumer cursor
+ * @param max largest number of samples to consume, 0 for all the available ones
+ * @param agg output, untouched if no samples were read
+ * @return number of samples aggregated
+ */
+size_t sample_ring_aggregate(struct sample_ring_t *ring, struct sample_reader_t *reader, size_t max,
+        struct sample_agg_t *agg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SAMPLE_RING_H
@@ -0,0 +1,141 @@
+/**
+ * @file ssd1306_fb.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief SSD1306 128x64 OLED driver on top of libi2c. Drawing happens in a RAM framebuffer that tracks the changed
+ *  column range of every page; ssd1306_fb_flush() sends only those ranges, as bulk data transfers
+ */
+
+#ifndef __SSD1306_FB_H
+#define __SSD1306_FB_H
+
+#include <libi2c.h>
+
+#define SSD1306_FB_ADDR         (0x3c)  // SA0 to GND, 0x3d otherwise
+#define SSD1306_FB_WIDTH        (128)
+#define SSD1306_FB_HEIGHT       (64)
+#define SSD1306_FB_PAGES        (SSD1306_FB_HEIGHT / 8)  // A page is a row of 8-pixel high columns, LSB on top
+
+#define SSD1306_CTRL_CMD        (0x00)  // Control byte: command stream follows
+#define SSD1306_CTRL_DATA       (0x40)  // Control byte: GDDRAM data stream follows
+#define SSD1306_CTRL_CO         (0x80)  // Control byte: a single byte follows, then another control byte
+
+#define SSD1306_CMD_SET_MODE    (0x20)  // 1 argument, addressing mode
+#define SSD1306_CMD_COL_RANGE   (0x21)  // 2 arguments, first and last column
+#define SSD1306_CMD_PAGE_RANGE  (0x22)  // 2 arguments, first and last page
+#define SSD1306_CMD_CONTRAST    (0x81)
+#define SSD1306_CMD_DISPLAY_OFF (0xae)
+#define SSD1306_CMD_DISPLAY_ON  (0xaf)
+#define SSD1306_MODE_HORIZONTAL (0x00)
+
+#ifndef SSD1306_FB_WINDOW_COST
+#define SSD1306_FB_WINDOW_COST  (12)  // Bytes on the wire to open a window: range commands, addressing, control bytes
+#endif
+
+/**
+ * @struct ssd1306_t
+ * @brief driver instance. One per display
+ * @var ssd1306_t::dev
+ *  i2c device
+ * @var ssd1306_t::fb
+ *  framebuffer, same layout as the controller's GDDRAM
+ * @var ssd1306_t::dirty_lo
+ *  per page: first changed column. dirty_lo > dirty_hi if the page is clean
+ * @var ssd1306_t::dirty_hi
+ *  per page: last changed column
+ */
+struct ssd1306_t {
+    struct i2c_dev_handle_t dev;
+    u8 fb[SSD1306_FB_PAGES][SSD1306_FB_WIDTH];
+    u8 dirty_lo[SSD1306_FB_PAGES];
+    u8 dirty_hi[SSD1306_FB_PAGES];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief configure the controller (charge pump, horizontal addressing, 128x64 mapping), clear it and turn it on
+ * @param disp driver instance
+ * @param port i2c port number. Must be initialized
+ * @param addr SSD1306_FB_ADDR or SSD1306_FB_ADDR + 1
+ * @return error code
+ */
+esp_err_t ssd1306_fb_init(struct ssd1306_t *disp, i2c_port_t port, i2c_addr_t addr);
+
+/**
+ * @brief send a command sequence, arguments included, in one transaction
+ * @param disp driver instance
+ * @param cmds commands
+ * @param size number of bytes
+ * @return error code
+ */
+esp_err_t ssd1306_fb_command(struct ssd1306_t *disp, const u8 *cmds, size_t size);
+
+/**
+ * @brief send the changed regions of the framebuffer and mark it clean. Bus time depends on what changed
+ *  since the last flush, not on the screen size
+ * @param disp driver instance
+ * @return error code. On error the framebuffer stays dirty
+ */
+esp_err_t ssd1306_fb_flush(struct ssd1306_t *disp);
+
+/**
+ * @brief mark a column range of a page as changed, e.g. after writing to disp->fb directly
+ * @param disp driver instance
+ * @param page page number
+ * @param lo first column
+ * @param hi last column
+ */
+void ssd1306_fb_mark_dirty(struct ssd1306_t *disp, u8 page, u8 lo, u8 hi);
+
+/**
+ * @brief clear the framebuffer
+ * @param disp driver instance
+ */
+void ssd1306_fb_clear(struct ssd1306_t *disp);
+
+/**
+ * @brief set or clear a pixel. Out of range coordinates are ignored
+ * @param disp driver instance
+ * @param x column
+ * @param y row
+ * @param on pixel state
+ */
+void ssd1306_fb_pixel(struct ssd1306_t *disp, int x, int y, bool on);
+
+/**
+ * @brief draw a horizontal line, clipped to the screen
+ * @param disp driver instance
+ * @param x0 first column
+ * @param x1 last column
+ * @param y row
+ */
+void ssd1306_fb_hline(struct ssd1306_t *disp, int x0, int x1, int y);
+
+/**
+ * @brief draw a vertical line, clipped to the screen
+ * @param disp driver instance
+ * @param x column
+ * @param y0 first row
+ * @param y1 last row
+ */
+void ssd1306_fb_vline(struct ssd1306_t *disp, int x, int y0, int y1);
+
+/**
+ * @brief copy columns of 8 pixels into a page, e.g. glyphs. Only the columns that actually change are marked
+ *  dirty. Clipped to the screen
+ * @param disp driver instance
+ * @param x first column
+ * @param page page number
+ * @param cols column bytes, LSB on top
+ * @param n number of columns
+ */
+void ssd1306_fb_blit(struct ssd1306_t *disp, int x, u8 page, const u8 *cols, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SSD1306_FB_H
@@ -0,0 +1,74 @@
+/**
+ * @file ssd1306_sim.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Simulated SSD1306, to be attached to the simulated bus
+ */
+
+#ifndef __SSD1306_SIM_H
+#define __SSD1306_SIM_H
+
+#include <i2c_sim.h>
+#include <ssd1306_fb.h>
+
+#define SSD1306_SIM_MAX_ARGS    (6)
+
+/**
+ * @struct ssd1306_sim_t
+ * @brief GDDRAM model: control bytes (Co, D/C#), page and horizontal/vertical addressing, column and page
+ *  ranges, display on/off. Other commands are parsed and ignored
+ * @var ssd1306_sim_t::dev
+ *  attachable device
+ * @var ssd1306_sim_t::ram
+ *  GDDRAM contents
+ * @var ssd1306_sim_t::on
+ *  display on
+ * @var ssd1306_sim_t::data_bytes
+ *  GDDRAM bytes written so far
+ * @var ssd1306_sim_t::cmds
+ *  commands executed so far, arguments excluded
+ */
+struct ssd1306_sim_t {
+    struct i2c_sim_dev_t dev;
+    u8 ram[SSD1306_FB_PAGES][SSD1306_FB_WIDTH];
+    bool on;
+    uint32_t data_bytes;
+    uint32_t cmds;
+    // Addressing
+    u8 mode;
+    u8 col, col_lo, col_hi;
+    u8 page, page_lo, page_hi;
+    // Parser
+    bool expect_ctrl;
+    u8 ctrl;
+    u8 cmd[1 + SSD1306_SIM_MAX_ARGS];
+    u8 cmd_len;
+    u8 cmd_need;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief initialize the model in its reset state
+ * @param model model to initialize
+ * @param addr SSD1306_FB_ADDR or SSD1306_FB_ADDR + 1
+ * @return pointer to the attachable device
+ */
+struct i2c_sim_dev_t *ssd1306_sim_init(struct ssd1306_sim_t *model, i2c_addr_t addr);
+
+/**
+ * @brief read a pixel of the GDDRAM
+ * @param model model
+ * @param x column, same coordinates as ssd1306_fb_pixel()
+ * @param y row
+ * @return pixel state, false if out of range
+ */
+bool ssd1306_sim_pixel(const struct ssd1306_sim_t *model, int x, int y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SSD1306_SIM_H
@@ -0,0 +1,89 @@
+/**
+ * @file ssd1306_text.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Incremental text on the SSD1306 framebuffer: a widget remembers the characters it shows and re-renders
+ *  only the cells whose character changed, so a flush sends only those
+ */
+
+#ifndef __SSD1306_TEXT_H
+#define __SSD1306_TEXT_H
+
+#include <ssd1306_fb.h>
+
+#define SSD1306_FONT_WIDTH      (6)  // 5 columns + 1 column of spacing, 8 rows
+#define SSD1306_FONT_FIRST      (0x20)
+#define SSD1306_FONT_LAST       (0x7f)
+#define SSD1306_FONT_GLYPHS     (SSD1306_FONT_LAST - SSD1306_FONT_FIRST + 1)
+#define SSD1306_DEGREE          "\x7f"  // Degree sign, replaces DEL
+#define SSD1306_TEXT_MAX_CELLS  (SSD1306_FB_WIDTH / SSD1306_FONT_WIDTH)
+
+/**
+ * @brief 6x8 ASCII font, column-major, LSB on top
+ */
+extern const u8 ssd1306_font6x8[SSD1306_FONT_GLYPHS][SSD1306_FONT_WIDTH];
+
+/**
+ * @struct ssd1306_text_t
+ * @brief fixed-width text field
+ * @var ssd1306_text_t::disp
+ *  display the field is drawn on
+ * @var ssd1306_text_t::x
+ *  first column
+ * @var ssd1306_text_t::page
+ *  first page
+ * @var ssd1306_text_t::cells
+ *  width in characters
+ * @var ssd1306_text_t::scale
+ *  1 for 6x8 characters, 2 for 12x16
+ * @var ssd1306_text_t::shown
+ *  characters currently rendered, 0 for none
+ */
+struct ssd1306_text_t {
+    struct ssd1306_t *disp;
+    int x;
+    u8 page;
+    u8 cells;
+    u8 scale;
+    char shown[SSD1306_TEXT_MAX_CELLS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief initialize a text field. Nothing is drawn until the first ssd1306_text_set()
+ * @param text field to initialize
+ * @param disp display
+ * @param x first column
+ * @param page first page
+ * @param cells width in characters, clipped to SSD1306_TEXT_MAX_CELLS
+ * @param scale 1 or 2
+ */
+void ssd1306_text_init(struct ssd1306_text_t *text, struct ssd1306_t *disp, int x, u8 page, u8 cells, u8 scale);
+
+/**
+ * @brief show a string: cells whose character changed are re-rendered into the framebuffer. The string is
+ *  truncated or padded with spaces to the field width. Call ssd1306_fb_flush() to send the changes
+ * @param text text field
+ * @param str string
+ * @return number of cells re-rendered
+ */
+size_t ssd1306_text_set(struct ssd1306_text_t *text, const char *str);
+
+/**
+ * @brief draw a string once, e.g. a static label
+ * @param disp display
+ * @param x first column
+ * @param page first page
+ * @param str string
+ * @param scale 1 or 2
+ */
+void ssd1306_text_draw(struct ssd1306_t *disp, int x, u8 page, const char *str, u8 scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SSD1306_TEXT_H
@@ -0,0 +1,310 @@
+/**
+ * @file bmp280.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Bosch BMP280 pressure and temperature sensor driver
+ */
+
+#include <bmp280.h>
+#include <i2c_regcache.h>
+#include "i2c_os.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+
+static uint16_t le16(const u8 *buf) {
+    return (uint16_t) (buf[0] | (buf[1] << 8));
+}
+
+static int32_t be20(const u8 *buf) {
+    return (int32_t) ((buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4));
+}
+
+esp_err_t bmp280_init(struct bmp280_t *bmp, i2c_port_t port, i2c_addr_t addr) {
+    u8 id;
+    bmp->dev = (struct i2c_dev_handle_t) {.port = port, .addr = addr};
+    bmp->t_fine = 0;
+    esp_err_t ret = bmp280_read_id(bmp, &id);
+    if (ret != ESP_OK)
+        return ret;
+    if (id != BMP280_CHIP_ID)
+        return ESP_ERR_INVALID_RESPONSE;
+    return bmp280_read_calib(bmp);
+}
+
+esp_err_t bmp280_read_id(struct bmp280_t *bmp, u8 *id) {
+    return i2c_read_register(&bmp->dev, BMP280_REG_ID, id, 1);
+}
+
+esp_err_t bmp280_read_calib(struct bmp280_t *bmp) {
+    u8 buf[BMP280_CALIB_LEN];
+    esp_err_t ret = i2c_read_register(&bmp->dev, BMP280_REG_CALIB, buf, sizeof(buf));
+    if (ret != ESP_OK)
+        return ret;
+    // Little endian words, in the same order as the struct
+    struct bmp280_calib_t *cp = &bmp->calib;
+    cp->dig_T1 = le16(buf + 0);
+    cp->dig_T2 = (int16_t) le16(buf + 2);
+    cp->dig_T3 = (int16_t) le16(buf + 4);
+    cp->dig_P1 = le16(buf + 6);
+    cp->dig_P2 = (int16_t) le16(buf + 8);
+    cp->dig_P3 = (int16_t) le16(buf + 10);
+    cp->dig_P4 = (int16_t) le16(buf + 12);
+    cp->dig_P5 = (int16_t) le16(buf + 14);
+    cp->dig_P6 = (int16_t) le16(buf + 16);
+    cp->dig_P7 = (int16_t) le16(buf + 18);
+    cp->dig_P8 = (int16_t) le16(buf + 20);
+    cp->dig_P9 = (int16_t) le16(buf + 22);
+    return ESP_OK;
+}
+
+esp_err_t bmp280_reset(struct bmp280_t *bmp) {
+    const u8 cmd = BMP280_RESET_VALUE;
+    esp_err_t ret = i2c_write_register(&bmp->dev, BMP280_REG_RESET, &cmd, 1);
+    i2c_regcache_invalidate(&bmp->dev);  // Registers back to their reset values
+    return ret;
+}
+
+void bmp280_use_cache(struct bmp280_t *bmp, struct i2c_regcache_t *cache) {
+    i2c_regcache_init(cache);
+    i2c_regcache_set_policy(cache, BMP280_REG_CALIB, BMP280_REG_CALIB + BMP280_CALIB_LEN - 1, I2C_REG_CACHED);
+    i2c_regcache_set_policy(cache, BMP280_REG_ID, BMP280_REG_ID, I2C_REG_CACHED);
+    i2c_regcache_set_policy(cache, BMP280_REG_CTRL_MEAS, BMP280_REG_CTRL_MEAS, I2C_REG_WRITE_THROUGH);  // Forced mode trigger
+    i2c_regcache_set_policy(cache, BMP280_REG_CONFIG, BMP280_REG_CONFIG, I2C_REG_CACHED);
+    i2c_regcache_attach(&bmp->dev, cache);
+}
+
+esp_err_t bmp280_nvm_busy(struct bmp280_t *bmp, bool *busy) {
+    u8 status;
+    esp_err_t ret = i2c_read_register(&bmp->dev, BMP280_REG_STATUS, &status, 1);
+    *busy = ret != ESP_OK || (status & BMP280_STATUS_IM_UPDATE);
+    return ret;
+}
+
+esp_err_t bmp280_wait_ready(struct bmp280_t *bmp, uint32_t timeout_ms) {
+    int64_t deadline = i2c_time_us() + (int64_t) timeout_ms * 1000;
+    bool busy;
+    while (bmp280_nvm_busy(bmp, &busy) != ESP_OK || busy) {  // Errors too: a resetting sensor doesn't ACK
+        if (i2c_time_us() >= deadline)
+            return ESP_ERR_TIMEOUT;
+        i2c_sleep_ms(BMP280_POLL_MS);
+    }
+    return ESP_OK;
+}
+
+esp_err_t bmp280_set_ctrl_meas(struct bmp280_t *bmp, u8 ctrl_meas) {
+    return i2c_write_register(&bmp->dev, BMP280_REG_CTRL_MEAS, &ctrl_meas, 1);
+}
+
+esp_err_t bmp280_set_mode(struct bmp280_t *bmp, u8 mode) {
+    return i2c_update_bits(&bmp->dev, BMP280_REG_CTRL_MEAS, BMP280_CTRL_MEAS_MODE, mode);
+}
+
+esp_err_t bmp280_set_oversampling(struct bmp280_t *bmp, u8 osrs_t, u8 osrs_p) {
+    return i2c_update_bits(&bmp->dev, BMP280_REG_CTRL_MEAS, BMP280_CTRL_MEAS_OSRS, BMP280_CTRL_MEAS(osrs_t, osrs_p, 0));
+}
+
+esp_err_t bmp280_read_raw(struct bmp280_t *bmp, struct bmp280_raw_t *raw) {
+    u8 buf[BMP280_DATA_LEN];
+    esp_err_t ret = i2c_read_register(&bmp->dev, BMP280_REG_DATA, buf, sizeof(buf));
+    if (ret != ESP_OK)
+        return ret;
+    raw->press = be20(buf);
+    raw->temp = be20(buf + 3);
+    return ESP_OK;
+}
+
+// Compensation formulas from the datasheet, 32-bit temperature and 64-bit pressure
+
+static inline int32_t calc_t_fine(const struct bmp280_calib_t *cp, int32_t raw_t) {
+    int32_t var1, var2;
+
+    var1 = ((((raw_t >> 3) - ((int32_t) cp->dig_T1 << 1)))
+            * ((int32_t) cp->dig_T2)) >> 11;
+
+    var2 = (((((raw_t >> 4) - ((int32_t) cp->dig_T1))
+            * ((raw_t >> 4) - ((int32_t) cp->dig_T1))) >> 12)
+            * ((int32_t) cp->dig_T3)) >> 14;
+
+    return var1 + var2;
+}
+
+static inline float calc_temp(int32_t t_fine) {
+    return ((t_fine * 5 + 128) >> 8) / 100.0f;
+}
+
+static inline float calc_press(const struct bmp280_calib_t *cp, int32_t t_fine, int32_t raw_p) {
+    int64_t var1, var2, p;
+
+    var1 = ((int64_t) t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t) cp->dig_P6;
+    var2 = var2 + ((var1 * (int64_t) cp->dig_P5) << 17);
+    var2 = var2 + (((int64_t) cp->dig_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t) cp->dig_P3) >> 8)
+            + ((var1 * (int64_t) cp->dig_P2) << 12);
+    var1 = (((((int64_t) 1) << 47) + var1)) * ((int64_t) cp->dig_P1)
+            >> 33;
+
+    if (var1 == 0) {
+        return -1; // avoid exception caused by division by zero
+    }
+    p = 1048576 - raw_p;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t) cp->dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t) cp->dig_P8) * p) >> 19;
+
+    p = ((p + var1 + var2) >> 8) + (((int64_t) cp->dig_P7) << 4);
+    p = p >> 8; // /256
+    return ((float) p / 100);
+}
+
+float bmp280_compensate_temp(struct bmp280_t *bmp, int32_t raw_t) {
+    bmp->t_fine = calc_t_fine(&bmp->calib, raw_t);
+    return calc_temp(bmp->t_fine);
+}
+
+float bmp280_compensate_press(struct bmp280_t *bmp, int32_t raw_p) {
+    return calc_press(&bmp->calib, bmp->t_fine, raw_p);
+}
+
+#ifdef __SSE2__
+// Low 32 bits of the lane-wise product, same for signed and unsigned operands
+static inline __m128i mullo_epi32(__m128i a, __m128i b) {
+#ifdef __SSE4_1__
+    return _mm_mullo_epi32(a, b);
+#else
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+// Four samples per iteration, the scalar loop below takes care of the tail
+static size_t batch_temp_simd(const struct bmp280_calib_t *cp, const int32_t *raw_t, int32_t *t_fine, float *temp, size_t n) {
+    const __m128i t1 = _mm_set1_epi32(cp->dig_T1);
+    const __m128i t1x2 = _mm_set1_epi32((int32_t) cp->dig_T1 << 1);
+    const __m128i t2 = _mm_set1_epi32(cp->dig_T2);
+    const __m128i t3 = _mm_set1_epi32(cp->dig_T3);
+    const __m128i round = _mm_set1_epi32(128);
+    const __m128 hundred = _mm_set1_ps(100.0f);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i raw = _mm_loadu_si128((const __m128i *) (raw_t + i));
+        __m128i var1 = _mm_srai_epi32(mullo_epi32(_mm_sub_epi32(_mm_srai_epi32(raw, 3), t1x2), t2), 11);
+        __m128i d = _mm_sub_epi32(_mm_srai_epi32(raw, 4), t1);
+        __m128i var2 = _mm_srai_epi32(mullo_epi32(_mm_srai_epi32(mullo_epi32(d, d), 12), t3), 14);
+        __m128i tf = _mm_add_epi32(var1, var2);
+        __m128i centi = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(tf, 2), tf), round), 8);  // t_fine * 5
+        _mm_storeu_si128((__m128i *) (t_fine + i), tf);
+        _mm_storeu_ps(temp + i, _mm_div_ps(_mm_cvtepi32_ps(centi), hundred));
+    }
+    return i;
+}
+#else
+static size_t batch_temp_simd(const struct bmp280_calib_t *cp, const int32_t *raw_t, int32_t *t_fine, float *temp, size_t n) {
+    (void) cp, (void) raw_t, (void) t_fine, (void) temp, (void) n;
+    return 0;
+}
+#endif
+
+// Plain loops over restrict pointers, with no cross-iteration state: compilers vectorize them where the target has SIMD
+static void batch_temp(const struct bmp280_calib_t *cp, const int32_t *restrict raw_t, int32_t *restrict t_fine,
+        float *restrict temp, size_t n) {
+    size_t i = batch_temp_simd(cp, raw_t, t_fine, temp, n);
+    for (; i < n; i++) {
+        t_fine[i] = calc_t_fine(cp, raw_t[i]);
+        temp[i] = calc_temp(t_fine[i]);
+    }
+}
+
+static void batch_press(const struct bmp280_calib_t *cp, const int32_t *restrict t_fine, const int32_t *restrict raw_p,
+        float *restrict press, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        press[i] = calc_press(cp, t_fine[i], raw_p[i]);
+}
+
+void bmp280_compensate_batch(const struct bmp280_calib_t *calib, const int32_t *raw_t, const int32_t *raw_p,
+        float *temp, float *press, size_t n) {
+    int32_t t_fine[BMP280_BATCH_BLOCK];
+    float temp_buf[BMP280_BATCH_BLOCK];
+
+    for (size_t off = 0; off < n; off += BMP280_BATCH_BLOCK) {
+        size_t len = n - off < BMP280_BATCH_BLOCK ? n - off : BMP280_BATCH_BLOCK;
+        batch_temp(calib, raw_t + off, t_fine, temp ? temp + off : temp_buf, len);
+        if (press)
+            batch_press(calib, t_fine, raw_p + off, press + off, len);
+    }
+}
+
+// Datasheet's 32-bit integer formulas, output in 0.01 degC and Pa
+
+static inline int32_t calc_t_fine_fixed(const struct bmp280_calib_t *cp, int32_t raw_t) {
+    int32_t var1, var2;
+
+    var1 = (((raw_t >> 3) - ((int32_t) cp->dig_T1 << 1)) * (int32_t) cp->dig_T2) >> 11;
+    var2 = (((((raw_t >> 4) - (int32_t) cp->dig_T1) * ((raw_t >> 4) - (int32_t) cp->dig_T1)) >> 12)
+        * (int32_t) cp->dig_T3) >> 14;
+    return var1 + var2;
+}
+
+static inline uint32_t calc_press_fixed(const struct bmp280_calib_t *cp, int32_t t_fine, int32_t raw_p) {
+    int32_t var1, var2;
+    uint32_t p;
+
+    var1 = (t_fine >> 1) - 64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * (int32_t) cp->dig_P6;
+    var2 = var2 + var1 * (int32_t) cp->dig_P5 * 2;
+    var2 = (var2 >> 2) + (int32_t) cp->dig_P4 * 65536;
+    var1 = ((((int32_t) cp->dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + (((int32_t) cp->dig_P2 * var1) >> 1)) >> 18;
+    var1 = ((32768 + var1) * (int32_t) cp->dig_P1) >> 15;
+
+    if (var1 == 0) {
+        return 0; // avoid exception caused by division by zero
+    }
+    p = (((uint32_t) (1048576 - raw_p)) - (var2 >> 12)) * 3125;
+    if (p < 0x80000000)
+        p = (p << 1) / (uint32_t) var1;
+    else
+        p = (p / (uint32_t) var1) * 2;
+    var1 = ((int32_t) cp->dig_P9 * ((int32_t) (((p >> 3) * (p >> 3)) >> 13))) >> 12;
+    var2 = (((int32_t) (p >> 2)) * (int32_t) cp->dig_P8) >> 13;
+    return (uint32_t) ((int32_t) p + ((var1 + var2 + (int32_t) cp->dig_P7) >> 4));
+}
+
+int32_t bmp280_compensate_temp_fixed(struct bmp280_t *bmp, int32_t raw_t) {
+    bmp->t_fine = calc_t_fine_fixed(&bmp->calib, raw_t);
+    return (bmp->t_fine * 5 + 128) >> 8;
+}
+
+uint32_t bmp280_compensate_press_fixed(struct bmp280_t *bmp, int32_t raw_p) {
+    return calc_press_fixed(&bmp->calib, bmp->t_fine, raw_p);
+}
+
+esp_err_t bmp280_read_fixed(struct bmp280_t *bmp, int32_t *temp, uint32_t *press) {
+    struct bmp280_raw_t raw;
+    esp_err_t ret = bmp280_read_raw(bmp, &raw);
+    if (ret != ESP_OK)
+        return ret;
+    if (raw.temp == BMP280_RAW_SKIPPED || raw.press == BMP280_RAW_SKIPPED)  // Measurement disabled
+        return ESP_ERR_INVALID_STATE;
+    *temp = bmp280_compensate_temp_fixed(bmp, raw.temp);
+    *press = bmp280_compensate_press_fixed(bmp, raw.press);
+    return ESP_OK;
+}
+
+esp_err_t bmp280_read(struct bmp280_t *bmp, float *temp, float *press) {
+    struct bmp280_raw_t raw;
+    esp_err_t ret = bmp280_read_raw(bmp, &raw);
+    if (ret != ESP_OK)
+        return ret;
+    if (raw.temp == BMP280_RAW_SKIPPED || raw.press == BMP280_RAW_SKIPPED)  // Measurement disabled
+        return ESP_ERR_INVALID_STATE;
+    *temp = bmp280_compensate_temp(bmp, raw.temp);
+    *press = bmp280_compensate_press(bmp, raw.press);
+    return ESP_OK;
+}
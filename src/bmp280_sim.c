@@ -0,0 +1,90 @@
+/**
+ * @file bmp280_sim.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Simulated BMP280
+ */
+
+#include <bmp280_sim.h>
+
+// Datasheet's example, section 3.12
+static const struct bmp280_calib_t example_calib = {
+    .dig_T1 = 27504, .dig_T2 = 26435, .dig_T3 = -1000,
+    .dig_P1 = 36477, .dig_P2 = -10685, .dig_P3 = 3024, .dig_P4 = 2855, .dig_P5 = 140,
+    .dig_P6 = -7, .dig_P7 = 15500, .dig_P8 = -14600, .dig_P9 = 6000,
+};
+
+#define EXAMPLE_RAW_TEMP    (519888)
+#define EXAMPLE_RAW_PRESS   (415148)
+
+static void put_be20(u8 *reg, int32_t raw) {
+    reg[0] = (u8) (raw >> 12);
+    reg[1] = (u8) (raw >> 4);
+    reg[2] = (u8) (raw << 4);
+}
+
+static void latch_data(struct bmp280_sim_t *model) {
+    put_be20(model->regs.regs + BMP280_REG_DATA, model->raw_press);
+    put_be20(model->regs.regs + BMP280_REG_DATA + 3, model->raw_temp);
+}
+
+static void power_on(struct bmp280_sim_t *model) {
+    u8 *regs = model->regs.regs;
+    regs[BMP280_REG_ID] = BMP280_CHIP_ID;
+    regs[BMP280_REG_CTRL_MEAS] = 0;
+    regs[BMP280_REG_CONFIG] = 0;
+    regs[BMP280_REG_STATUS] = 0;
+    put_be20(regs + BMP280_REG_DATA, BMP280_RAW_SKIPPED);
+    put_be20(regs + BMP280_REG_DATA + 3, BMP280_RAW_SKIPPED);
+}
+
+static void on_write(struct i2c_sim_regs_t *regs, u8 reg, u8 data) {
+    struct bmp280_sim_t *model = (struct bmp280_sim_t *) regs;
+    if (reg == BMP280_REG_RESET && data == BMP280_RESET_VALUE) {
+        power_on(model);
+        model->nvm_reads = BMP280_SIM_NVM_READS;
+    }
+    regs->regs[BMP280_REG_RESET] = 0;  // Reads as 0x00
+}
+
+static void on_read(struct i2c_sim_regs_t *regs, u8 reg) {
+    struct bmp280_sim_t *model = (struct bmp280_sim_t *) regs;
+    if (reg == BMP280_REG_STATUS) {
+        regs->regs[reg] = model->nvm_reads ? BMP280_STATUS_IM_UPDATE : 0;
+        if (model->nvm_reads)
+            model->nvm_reads--;
+    } else if (reg == BMP280_REG_DATA && (regs->regs[BMP280_REG_CTRL_MEAS] & 0x03) != BMP280_MODE_SLEEP) {
+        latch_data(model);  // Whole burst comes from the same measurement
+        if ((regs->regs[BMP280_REG_CTRL_MEAS] & 0x03) != BMP280_MODE_NORMAL)
+            regs->regs[BMP280_REG_CTRL_MEAS] &= ~0x03;  // Forced mode: back to sleep
+    }
+}
+
+struct i2c_sim_dev_t *bmp280_sim_init(struct bmp280_sim_t *model, i2c_addr_t addr) {
+    struct i2c_sim_dev_t *dev = i2c_sim_regs_init(&model->regs, addr);
+    model->regs.on_write = on_write;
+    model->regs.on_read = on_read;
+    model->nvm_reads = 0;
+    power_on(model);
+    bmp280_sim_set_calib(model, &example_calib);
+    bmp280_sim_set_raw(model, EXAMPLE_RAW_TEMP, EXAMPLE_RAW_PRESS);
+    return dev;
+}
+
+void bmp280_sim_set_raw(struct bmp280_sim_t *model, int32_t raw_temp, int32_t raw_press) {
+    model->raw_temp = raw_temp;
+    model->raw_press = raw_press;
+}
+
+void bmp280_sim_set_calib(struct bmp280_sim_t *model, const struct bmp280_calib_t *calib) {
+    const uint16_t words[] = {
+        calib->dig_T1, (uint16_t) calib->dig_T2, (uint16_t) calib->dig_T3,
+        calib->dig_P1, (uint16_t) calib->dig_P2, (uint16_t) calib->dig_P3, (uint16_t) calib->dig_P4,
+        (uint16_t) calib->dig_P5, (uint16_t) calib->dig_P6, (uint16_t) calib->dig_P7, (uint16_t) calib->dig_P8,
+        (uint16_t) calib->dig_P9,
+    };
+    for (int i = 0; i < BMP280_CALIB_LEN / 2; i++) {
+        model->regs.regs[BMP280_REG_CALIB + 2 * i] = (u8) words[i];
+        model->regs.regs[BMP280_REG_CALIB + 2 * i + 1] = (u8) (words[i] >> 8);
+    }
+}
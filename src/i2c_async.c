@@ -0,0 +1,152 @@
+/**
+ * @file i2c_async.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Per-port transaction queue and worker
+ */
+
+#include <i2c_async.h>
+#include "i2c_os.h"
+
+struct async_port_t {
+    i2c_port_t port;
+    i2c_lock_t lock;  // Protects the queue and stopping
+    i2c_sem_t wake;
+    i2c_sem_t stopped;
+    struct i2c_xfer_t *head;
+    struct i2c_xfer_t *tail;
+    bool running;  // Atomic
+    bool stopping;
+};
+
+static struct async_port_t ports[I2C_NUM_MAX] = {
+    [0 ... I2C_NUM_MAX - 1] = {.lock = I2C_LOCK_INITIALIZER},
+};
+
+static const char *worker_names[] = {"i2c_async_0", "i2c_async_1"};
+
+/**
+ * @brief detach the whole queue, so that the worker runs it without touching the lock
+ * @return queued descriptors, in submission order
+ */
+static struct i2c_xfer_t *take_all(struct async_port_t *p) {
+    i2c_lock_take(&p->lock);
+    struct i2c_xfer_t *list = p->head;
+    p->head = p->tail = NULL;
+    i2c_lock_give(&p->lock);
+    return list;
+}
+
+/**
+ * @brief whether the worker can exit: stopping, and nothing left. Once true no descriptor can get in anymore, since
+ *  i2c_submit checks stopping under the same lock
+ */
+static bool finished(struct async_port_t *p) {
+    i2c_lock_take(&p->lock);
+    bool ret = p->stopping && !p->head;
+    i2c_lock_give(&p->lock);
+    return ret;
+}
+
+static void worker(void *arg) {
+    struct async_port_t *p = arg;
+    while (true) {
+        i2c_sem_take(&p->wake);
+        // Drain back-to-back: everything queued so far, then whatever was queued meanwhile
+        for (struct i2c_xfer_t *xfer = take_all(p); xfer; xfer = xfer ? xfer : take_all(p)) {
+            struct i2c_xfer_t *next = xfer->next;
+            xfer->next = NULL;
+            xfer->result = i2c_transfer(xfer->dev, xfer->msgs, xfer->n);
+            if (xfer->done)
+                xfer->done(xfer, xfer->arg);  // Can resubmit xfer: next has already been saved
+            xfer = next;
+        }
+        if (finished(p))
+            break;  // Otherwise a late submit is queued: its wake is pending, drain it too
+    }
+    __atomic_store_n(&p->running, false, __ATOMIC_RELEASE);
+    i2c_sem_give(&p->stopped);
+    i2c_thread_exit();
+}
+
+esp_err_t i2c_async_start(i2c_port_t port, int core) {
+    if (port >= I2C_NUM_MAX || !i2c_get_backend(port))
+        return ESP_ERR_INVALID_STATE;
+    struct async_port_t *p = &ports[port];
+    if (__atomic_load_n(&p->running, __ATOMIC_ACQUIRE))
+        return ESP_OK;
+    i2c_lock_init(&p->lock);
+    i2c_sem_init(&p->wake);
+    i2c_sem_init(&p->stopped);
+    p->port = port;
+    p->head = p->tail = NULL;
+    p->stopping = false;
+    __atomic_store_n(&p->running, true, __ATOMIC_RELEASE);
+    if (!i2c_thread_start(worker, p, worker_names[port % 2], I2C_ASYNC_PRIO, core)) {
+        __atomic_store_n(&p->running, false, __ATOMIC_RELEASE);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void i2c_async_stop(i2c_port_t port) {
+    struct async_port_t *p = &ports[port];
+    if (!__atomic_load_n(&p->running, __ATOMIC_ACQUIRE))
+        return;
+    i2c_lock_take(&p->lock);
+    p->stopping = true;
+    i2c_lock_give(&p->lock);
+    i2c_sem_give(&p->wake);
+    i2c_sem_take(&p->stopped);
+}
+
+esp_err_t i2c_submit(struct i2c_xfer_t *xfer) {
+    if (!xfer || !xfer->dev || xfer->n > I2C_XFER_MAX_MSGS || xfer->dev->port >= I2C_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+    struct async_port_t *p = &ports[xfer->dev->port];
+    if (!__atomic_load_n(&p->running, __ATOMIC_ACQUIRE))
+        return ESP_ERR_INVALID_STATE;
+    xfer->next = NULL;
+    i2c_lock_take(&p->lock);
+    if (p->stopping) {  // Checked with the lock held: the worker's last look at the queue happens under it too
+        i2c_lock_give(&p->lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (p->tail)
+        p->tail->next = xfer;
+    else
+        p->head = xfer;
+    p->tail = xfer;
+    i2c_lock_give(&p->lock);
+    i2c_sem_give(&p->wake);
+    return ESP_OK;
+}
+
+struct i2c_xfer_t *i2c_xfer_read_register(struct i2c_xfer_t *xfer, const struct i2c_dev_handle_t *dev, u8 reg,
+        u8 *data, size_t size, i2c_xfer_cb_t done, void *arg) {
+    xfer->dev = dev;
+    xfer->reg = reg;
+    xfer->msgs[0] = (struct i2c_msg_t) {.buf = &xfer->reg, .len = 1, .flags = I2C_MSG_WRITE};
+    xfer->msgs[1] = (struct i2c_msg_t) {.buf = data, .len = size, .flags = I2C_MSG_READ};
+    xfer->n = 2;
+    xfer->done = done;
+    xfer->arg = arg;
+    return xfer;
+}
+
+struct i2c_xfer_t *i2c_xfer_write(struct i2c_xfer_t *xfer, const struct i2c_dev_handle_t *dev, const u8 *data,
+        size_t size, i2c_xfer_cb_t done, void *arg) {
+    xfer->dev = dev;
+    xfer->msgs[0] = (struct i2c_msg_t) {.buf = (u8 *) data, .len = size, .flags = I2C_MSG_WRITE};
+    xfer->n = 1;
+    xfer->done = done;
+    xfer->arg = arg;
+    return xfer;
+}
+
+#ifdef ESP_PLATFORM
+void i2c_xfer_notify_task(struct i2c_xfer_t *xfer, void *task) {
+    (void) xfer;
+    xTaskNotifyGive((TaskHandle_t) task);
+}
+#endif
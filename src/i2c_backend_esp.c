@@ -0,0 +1,198 @@
+/**
+ * @file i2c_backend_esp.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief ESP-IDF legacy i2c driver backend
+ */
+
+#ifdef ESP_PLATFORM
+
+#include <stdatomic.h>
+#include <libi2c.h>
+#include <i2c_backend.h>
+#include <i2c_esp.h>
+#include <soc/soc.h>
+#include <driver/gpio.h>
+#include <esp_rom_sys.h>
+
+#define POOL_SLOT_SIZE  I2C_LINK_RECOMMENDED_SIZE(I2C_CMD_POOL_TRANSACTIONS)
+#define RECOVERY_PULSES (9)  // A slave stuck mid-byte lets SDA go within 8 data bits and the ACK
+#define RECOVERY_HALF_US (5)  // 100 kHz while bit-banging
+
+struct cmd_pool_t {
+    u8 buf[I2C_CMD_POOL_SLOTS][POOL_SLOT_SIZE] __attribute__((aligned(4)));
+    atomic_flag busy[I2C_CMD_POOL_SLOTS];
+    atomic_uint static_links;
+    atomic_uint heap_links;
+};
+
+static struct cmd_pool_t pools[I2C_NUM_MAX];
+static struct i2c_bus_t buses[I2C_NUM_MAX];  // Configuration to restore after a recovery, current clock included
+
+/**
+ * @brief claim a free pool slot
+ * @return slot index, -1 if all slots are in use
+ */
+static int pool_claim(struct cmd_pool_t *pool) {
+    for (int i = 0; i < I2C_CMD_POOL_SLOTS; i++) {
+        if (!atomic_flag_test_and_set_explicit(&pool->busy[i], memory_order_acquire))
+            return i;
+    }
+    return -1;
+}
+
+static void pool_release(struct cmd_pool_t *pool, int slot) {
+    atomic_flag_clear_explicit(&pool->busy[slot], memory_order_release);
+}
+
+/**
+ * @brief queue the commands of a transaction
+ * @return ESP_ERR_NO_MEM if the link storage is exhausted
+ */
+static esp_err_t build(i2c_cmd_handle_t cmd, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n) {
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < n && ret == ESP_OK; i++) {
+        bool read = msgs[i].flags & I2C_MSG_READ;
+        if (!(msgs[i].flags & I2C_MSG_NOSTART)) {
+            ret = i2c_master_start(cmd);
+            if (ret == ESP_OK)
+                ret = i2c_master_write_byte(cmd, (addr << 1) | (read ? READ_BIT : WRITE_BIT), ACK_CHECK_EN);
+        }
+        if (ret != ESP_OK || !msgs[i].len)
+            continue;
+        if (read) {
+            // NACK the last byte before a STOP or a repeated START
+            bool last = i == n - 1 || !(msgs[i + 1].flags & I2C_MSG_NOSTART);
+            if (msgs[i].len > 1) {
+                ret = i2c_master_read(cmd, msgs[i].buf, msgs[i].len - 1, ACK_VAL);
+            }
+            if (ret == ESP_OK)
+                ret = i2c_master_read_byte(cmd, msgs[i].buf + msgs[i].len - 1, last ? NACK_VAL : ACK_VAL);
+        } else {
+            ret = i2c_master_write(cmd, msgs[i].buf, msgs[i].len, ACK_CHECK_EN);
+        }
+    }
+    if (ret == ESP_OK)
+        ret = i2c_master_stop(cmd);
+    return ret;
+}
+
+// At least one tick: a short timeout must not turn into "don't wait at all"
+static TickType_t to_ticks(uint32_t timeout_ms) {
+    TickType_t ticks = timeout_ms / portTICK_RATE_MS;
+    return ticks ? ticks : 1;
+}
+
+static esp_err_t esp_init(const struct i2c_bus_t *conf) {
+    buses[conf->port] = *conf;
+    esp_err_t ret = i2c_param_config(conf->port, &(conf->conf));
+    if (ret != ESP_OK)
+        return ret;
+    return i2c_driver_install(conf->port, conf->conf.mode, conf->rx, conf->tx, 0);
+}
+
+static esp_err_t esp_deinit(i2c_port_t port) {
+    return i2c_driver_delete(port);
+}
+
+static esp_err_t esp_transfer(i2c_port_t port, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n, uint32_t timeout_ms) {
+    struct cmd_pool_t *pool = &pools[port];
+    i2c_cmd_handle_t cmd = NULL;
+    esp_err_t ret;
+    int slot = pool_claim(pool);
+
+    if (slot >= 0) {
+        cmd = i2c_cmd_link_create_static(pool->buf[slot], POOL_SLOT_SIZE);
+        if (cmd && build(cmd, addr, msgs, n) == ESP_OK) {
+            atomic_fetch_add_explicit(&pool->static_links, 1, memory_order_relaxed);
+            ret = i2c_master_cmd_begin(port, cmd, to_ticks(timeout_ms));
+            i2c_cmd_link_delete_static(cmd);
+            pool_release(pool, slot);
+            return ret;
+        }
+        if (cmd)
+            i2c_cmd_link_delete_static(cmd);
+        pool_release(pool, slot);
+    }
+
+    // Slow path: pool exhausted or transaction too long for a slot
+    atomic_fetch_add_explicit(&pool->heap_links, 1, memory_order_relaxed);
+    cmd = i2c_cmd_link_create();
+    if (!cmd)
+        return ESP_ERR_NO_MEM;
+    ret = build(cmd, addr, msgs, n);
+    if (ret == ESP_OK)
+        ret = i2c_master_cmd_begin(port, cmd, to_ticks(timeout_ms));
+    i2c_cmd_link_delete(cmd);
+    return ret;
+}
+
+// Same timings i2c_param_config() derives from clk_speed, without touching the pins or the driver
+static esp_err_t esp_set_clock(i2c_port_t port, uint32_t hz) {
+    if (!hz)
+        return ESP_ERR_INVALID_ARG;
+    buses[port].conf.master.clk_speed = hz;
+    int half = APB_CLK_FREQ / hz / 2;
+    esp_err_t ret = i2c_set_period(port, half, half);
+    if (ret == ESP_OK)
+        ret = i2c_set_start_timing(port, half, half);
+    if (ret == ESP_OK)
+        ret = i2c_set_stop_timing(port, half, half);
+    if (ret == ESP_OK)
+        ret = i2c_set_data_timing(port, half / 2, half / 2);
+    return ret;
+}
+
+static void half_bit(void) {
+    esp_rom_delay_us(RECOVERY_HALF_US);
+}
+
+// Controller reset and bit-banged bus clear on the same pins, then the driver is installed again
+static esp_err_t esp_recover(i2c_port_t port, unsigned *pulses) {
+    struct i2c_bus_t *bus = &buses[port];
+    gpio_num_t scl = bus->conf.scl_io_num, sda = bus->conf.sda_io_num;
+    *pulses = 0;
+    if (bus->conf.mode != I2C_MODE_MASTER)
+        return ESP_ERR_NOT_SUPPORTED;
+    i2c_driver_delete(port);  // FSM, FIFOs and interrupt state go with it
+    gpio_set_level(scl, 1);
+    gpio_set_level(sda, 1);
+    gpio_set_direction(scl, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_direction(sda, GPIO_MODE_INPUT_OUTPUT_OD);
+    half_bit();
+    while (!gpio_get_level(sda) && *pulses < RECOVERY_PULSES) {
+        gpio_set_level(scl, 0);
+        half_bit();
+        gpio_set_level(scl, 1);
+        half_bit();
+        (*pulses)++;
+    }
+    // STOP: SDA rises while SCL is high
+    gpio_set_level(scl, 0);
+    half_bit();
+    gpio_set_level(sda, 0);
+    half_bit();
+    gpio_set_level(scl, 1);
+    half_bit();
+    gpio_set_level(sda, 1);
+    half_bit();
+    bool free = gpio_get_level(sda);
+    esp_err_t ret = esp_init(bus);  // Pins back to the controller
+    return ret == ESP_OK && !free ? ESP_FAIL : ret;
+}
+
+const struct i2c_backend_t i2c_backend_esp = {
+    .name = "esp-idf",
+    .init = esp_init,
+    .deinit = esp_deinit,
+    .transfer = esp_transfer,
+    .set_clock = esp_set_clock,
+    .recover = esp_recover,
+};
+
+void i2c_esp_get_pool_stats(i2c_port_t port, struct i2c_cmd_pool_stats_t *stats) {
+    stats->static_links = atomic_load_explicit(&pools[port].static_links, memory_order_relaxed);
+    stats->heap_links = atomic_load_explicit(&pools[port].heap_links, memory_order_relaxed);
+}
+
+#endif  // ESP_PLATFORM
@@ -0,0 +1,354 @@
+/**
+ * @file i2c_backend_linux.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Linux i2c-dev backend
+ */
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+#include <i2c_linux.h>
+
+#define NO_SLAVE        (-1)
+#define DEV_PATH_LEN    (32)
+#define RDWR_MSG_MAX    (8192)  // i2c-dev rejects longer I2C_RDWR messages with EINVAL
+
+struct linux_port_t {
+    i2c_port_t port;
+    int fd;
+    int adapter;
+    bool adapter_set;
+    unsigned long funcs;
+    int slave;  // Address last set with I2C_SLAVE, used by SMBus transfers
+    uint32_t timeout_ms;
+    uint64_t ioctls;
+    int (*ioctl)(struct linux_port_t *p, unsigned long req, void *arg);
+    unsigned long sim_funcs;
+    u8 bounce[RDWR_MSG_MAX];  // Merged write continuations, used under the port lock
+};
+
+static struct linux_port_t ports[I2C_NUM_MAX];
+
+static int dev_ioctl(struct linux_port_t *p, unsigned long req, void *arg) {
+    return ioctl(p->fd, req, arg);
+}
+
+static int port_ioctl(struct linux_port_t *p, unsigned long req, void *arg) {
+    p->ioctls++;
+    return p->ioctl(p, req, arg);
+}
+
+static esp_err_t errno_to_err(int err) {
+    switch (err) {
+        case ETIMEDOUT:
+            return ESP_ERR_TIMEOUT;
+        case EOPNOTSUPP:
+            return ESP_ERR_NOT_SUPPORTED;
+        case EINVAL:
+            return ESP_ERR_INVALID_ARG;
+        case EAGAIN:
+            return I2C_ERR_ARB_LOST;
+        default:  // ENXIO, EREMOTEIO, EIO: NACK
+            return ESP_FAIL;
+    }
+}
+
+// Local adapter: executes i2c-dev ioctls on the simulated bus
+
+static esp_err_t sim_run(struct linux_port_t *p, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n) {
+    return i2c_backend_sim.transfer(p->port, addr, msgs, n, p->timeout_ms);
+}
+
+static int sim_smbus(struct linux_port_t *p, struct i2c_smbus_ioctl_data *args) {
+    union i2c_smbus_data *data = args->data;
+    u8 cmd = args->command;
+    struct i2c_msg_t msgs[2] = {
+        {.buf = &cmd, .len = 1, .flags = I2C_MSG_WRITE},
+        {.buf = data ? data->block : NULL, .len = 1, .flags = I2C_MSG_READ},
+    };
+    size_t n = 2;
+    bool read = args->read_write == I2C_SMBUS_READ;
+
+    switch (args->size) {
+        case I2C_SMBUS_QUICK:
+            msgs[0].len = 0;
+            n = 1;
+            break;
+        case I2C_SMBUS_BYTE:
+            if (read)
+                msgs[0] = msgs[1];
+            n = 1;
+            break;
+        case I2C_SMBUS_BYTE_DATA:
+            if (!read)
+                msgs[1].flags = I2C_MSG_WRITE | I2C_MSG_NOSTART;
+            break;
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            msgs[1].buf = data->block + 1;
+            msgs[1].len = data->block[0];
+            if (!read)
+                msgs[1].flags = I2C_MSG_WRITE | I2C_MSG_NOSTART;
+            break;
+        default:
+            errno = EOPNOTSUPP;
+            return -1;
+    }
+    if (sim_run(p, (i2c_addr_t) p->slave, msgs, n) != ESP_OK) {
+        errno = ENXIO;
+        return -1;
+    }
+    return 0;
+}
+
+static int sim_ioctl(struct linux_port_t *p, unsigned long req, void *arg) {
+    switch (req) {
+        case I2C_FUNCS:
+            *(unsigned long *) arg = p->sim_funcs;
+            return 0;
+        case I2C_SLAVE:
+        case I2C_TIMEOUT:
+            return 0;  // Both tracked by the caller
+        case I2C_SMBUS:
+            return sim_smbus(p, arg);
+        case I2C_RDWR: {
+            struct i2c_rdwr_ioctl_data *rdwr = arg;
+            struct i2c_msg_t msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+            if (!(p->sim_funcs & I2C_FUNC_I2C) || rdwr->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS) {
+                errno = EOPNOTSUPP;
+                return -1;
+            }
+            for (uint32_t i = 0; i < rdwr->nmsgs; i++) {
+                if (rdwr->msgs[i].len > RDWR_MSG_MAX) {
+                    errno = EINVAL;
+                    return -1;
+                }
+                msgs[i].buf = rdwr->msgs[i].buf;
+                msgs[i].len = rdwr->msgs[i].len;
+                msgs[i].flags = (rdwr->msgs[i].flags & I2C_M_RD ? I2C_MSG_READ : I2C_MSG_WRITE)
+                    | (rdwr->msgs[i].flags & I2C_M_NOSTART ? I2C_MSG_NOSTART : 0);
+            }
+            if (rdwr->nmsgs && sim_run(p, (i2c_addr_t) rdwr->msgs[0].addr, msgs, rdwr->nmsgs) != ESP_OK) {
+                errno = ENXIO;
+                return -1;
+            }
+            return (int) rdwr->nmsgs;
+        }
+        default:
+            errno = ENOTTY;
+            return -1;
+    }
+}
+
+// Backend
+
+static esp_err_t linux_init(const struct i2c_bus_t *conf) {
+    struct linux_port_t *p = &ports[conf->port];
+    p->port = conf->port;
+    p->slave = NO_SLAVE;
+    p->timeout_ms = 0;
+    p->ioctls = 0;
+    if (p->ioctl == sim_ioctl) {
+        p->fd = -1;
+        i2c_backend_sim.init(conf);
+    } else {
+        char path[DEV_PATH_LEN];
+        snprintf(path, sizeof(path), "/dev/i2c-%d", p->adapter_set ? p->adapter : (int) conf->port);
+        p->ioctl = dev_ioctl;
+        p->fd = open(path, O_RDWR);
+        if (p->fd < 0)
+            return ESP_ERR_NOT_FOUND;
+    }
+    if (port_ioctl(p, I2C_FUNCS, &p->funcs) < 0) {
+        esp_err_t ret = errno_to_err(errno);
+        if (p->fd >= 0)
+            close(p->fd);
+        p->fd = -1;
+        return ret;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t linux_deinit(i2c_port_t port) {
+    struct linux_port_t *p = &ports[port];
+    if (p->fd >= 0)
+        close(p->fd);
+    p->fd = -1;
+    return ESP_OK;
+}
+
+static esp_err_t set_timeout(struct linux_port_t *p, uint32_t timeout_ms) {
+    if (timeout_ms == p->timeout_ms)
+        return ESP_OK;
+    // Kernel unit is 10 ms, rounded up so that short timeouts don't become "no timeout"
+    if (port_ioctl(p, I2C_TIMEOUT, (void *) (uintptr_t) ((timeout_ms + 9) / 10)) < 0)
+        return errno_to_err(errno);
+    p->timeout_ms = timeout_ms;
+    return ESP_OK;
+}
+
+static esp_err_t rdwr_transfer(struct linux_port_t *p, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n) {
+    struct i2c_msg kmsgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    bool nostart = p->funcs & I2C_FUNC_NOSTART;
+    size_t bounce_len = 0, k = 0;
+    u8 *fill = p->bounce;
+
+    // Without I2C_FUNC_NOSTART, write continuations are merged with their head into the port's bounce buffer
+    if (!nostart) {
+        for (size_t i = 1; i < n; i++) {
+            if (!(msgs[i].flags & I2C_MSG_NOSTART))
+                continue;
+            if ((msgs[i].flags | msgs[i - 1].flags) & I2C_MSG_READ)
+                return ESP_ERR_NOT_SUPPORTED;
+            bounce_len += msgs[i].len + (msgs[i - 1].flags & I2C_MSG_NOSTART ? 0 : msgs[i - 1].len);
+        }
+        if (bounce_len > sizeof(p->bounce))
+            return ESP_ERR_INVALID_SIZE;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bool cont = i > 0 && (msgs[i].flags & I2C_MSG_NOSTART);
+        bool head = !nostart && i + 1 < n && (msgs[i + 1].flags & I2C_MSG_NOSTART) && !cont;
+        if (cont && !nostart) {
+            if (kmsgs[k - 1].len + msgs[i].len > RDWR_MSG_MAX)
+                return ESP_ERR_INVALID_SIZE;
+            memcpy(fill, msgs[i].buf, msgs[i].len);
+            fill += msgs[i].len;
+            kmsgs[k - 1].len += msgs[i].len;
+            continue;
+        }
+        if (k == I2C_RDWR_IOCTL_MAX_MSGS || msgs[i].len > RDWR_MSG_MAX)
+            return ESP_ERR_INVALID_SIZE;
+        kmsgs[k] = (struct i2c_msg) {
+            .addr = addr,
+            .flags = (msgs[i].flags & I2C_MSG_READ ? I2C_M_RD : 0) | (cont ? I2C_M_NOSTART : 0),
+            .len = (uint16_t) msgs[i].len,
+            .buf = msgs[i].buf,
+        };
+        if (head) {
+            memcpy(fill, msgs[i].buf, msgs[i].len);
+            kmsgs[k].buf = fill;
+            fill += msgs[i].len;
+        }
+        k++;
+    }
+
+    struct i2c_rdwr_ioctl_data rdwr = {.msgs = kmsgs, .nmsgs = (uint32_t) k};
+    if (port_ioctl(p, I2C_RDWR, &rdwr) < 0)
+        return errno_to_err(errno);
+    return ESP_OK;
+}
+
+static esp_err_t smbus_access(struct linux_port_t *p, char rw, u8 cmd, int size, union i2c_smbus_data *data) {
+    struct i2c_smbus_ioctl_data args = {.read_write = rw, .command = cmd, .size = size, .data = data};
+    if (port_ioctl(p, I2C_SMBUS, &args) < 0)
+        return errno_to_err(errno);
+    return ESP_OK;
+}
+
+static esp_err_t smbus_transfer(struct linux_port_t *p, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n) {
+    union i2c_smbus_data data;
+    u8 flat[1 + I2C_SMBUS_BLOCK_MAX];
+    size_t len = 0;
+    esp_err_t ret;
+
+    if (p->slave != addr) {
+        if (port_ioctl(p, I2C_SLAVE, (void *) (uintptr_t) addr) < 0)
+            return errno_to_err(errno);
+        p->slave = addr;
+    }
+
+    // Register read: write the pointer, then read
+    if (n == 2 && !(msgs[0].flags & I2C_MSG_READ) && msgs[0].len == 1
+            && (msgs[1].flags & (I2C_MSG_READ | I2C_MSG_NOSTART)) == I2C_MSG_READ) {
+        if (msgs[1].len == 1) {
+            ret = smbus_access(p, I2C_SMBUS_READ, msgs[0].buf[0], I2C_SMBUS_BYTE_DATA, &data);
+            msgs[1].buf[0] = data.byte;
+            return ret;
+        }
+        if (msgs[1].len > I2C_SMBUS_BLOCK_MAX)
+            return ESP_ERR_NOT_SUPPORTED;
+        data.block[0] = (u8) msgs[1].len;
+        ret = smbus_access(p, I2C_SMBUS_READ, msgs[0].buf[0], I2C_SMBUS_I2C_BLOCK_DATA, &data);
+        memcpy(msgs[1].buf, data.block + 1, msgs[1].len);
+        return ret;
+    }
+
+    // Plain read: byte reads, the slave auto-increments its pointer
+    if (n == 1 && (msgs[0].flags & I2C_MSG_READ)) {
+        for (size_t i = 0; i < msgs[0].len; i++) {
+            ret = smbus_access(p, I2C_SMBUS_READ, 0, I2C_SMBUS_BYTE, &data);
+            if (ret != ESP_OK)
+                return ret;
+            msgs[0].buf[i] = data.byte;
+        }
+        return ESP_OK;
+    }
+
+    // Write: flatten continuations, first byte is the command
+    for (size_t i = 0; i < n; i++) {
+        if ((msgs[i].flags & I2C_MSG_READ) || (i && !(msgs[i].flags & I2C_MSG_NOSTART))
+                || len + msgs[i].len > sizeof(flat))
+            return ESP_ERR_NOT_SUPPORTED;
+        memcpy(flat + len, msgs[i].buf, msgs[i].len);
+        len += msgs[i].len;
+    }
+    switch (len) {
+        case 0:
+            return smbus_access(p, I2C_SMBUS_WRITE, 0, I2C_SMBUS_QUICK, NULL);
+        case 1:
+            return smbus_access(p, I2C_SMBUS_WRITE, flat[0], I2C_SMBUS_BYTE, NULL);
+        case 2:
+            data.byte = flat[1];
+            return smbus_access(p, I2C_SMBUS_WRITE, flat[0], I2C_SMBUS_BYTE_DATA, &data);
+        default:
+            data.block[0] = (u8) (len - 1);
+            memcpy(data.block + 1, flat + 1, len - 1);
+            return smbus_access(p, I2C_SMBUS_WRITE, flat[0], I2C_SMBUS_I2C_BLOCK_DATA, &data);
+    }
+}
+
+static esp_err_t linux_transfer(i2c_port_t port, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n, uint32_t timeout_ms) {
+    struct linux_port_t *p = &ports[port];
+    esp_err_t ret = set_timeout(p, timeout_ms);
+    if (ret != ESP_OK)
+        return ret;
+    if (p->funcs & I2C_FUNC_I2C)
+        return rdwr_transfer(p, addr, msgs, n);
+    return smbus_transfer(p, addr, msgs, n);
+}
+
+static size_t linux_max_transfer(i2c_port_t port) {
+    // I2C_RDWR: i2c-dev's message limit, one byte left for a merged prefix. SMBus: one block
+    return ports[port].funcs & I2C_FUNC_I2C ? RDWR_MSG_MAX - 1 : I2C_SMBUS_BLOCK_MAX;
+}
+
+const struct i2c_backend_t i2c_backend_linux = {
+    .name = "linux-i2c-dev",
+    .init = linux_init,
+    .deinit = linux_deinit,
+    .transfer = linux_transfer,
+    .max_transfer = linux_max_transfer,
+};
+
+void i2c_linux_set_adapter(i2c_port_t port, int adapter) {
+    ports[port].adapter = adapter;
+    ports[port].adapter_set = true;
+}
+
+void i2c_linux_use_sim(i2c_port_t port, unsigned long funcs) {
+    ports[port].ioctl = sim_ioctl;
+    ports[port].sim_funcs = funcs;
+}
+
+uint64_t i2c_linux_ioctl_count(i2c_port_t port) {
+    return ports[port].ioctls;
+}
+
+#endif  // __linux__ && !ESP_PLATFORM
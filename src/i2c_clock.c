@@ -0,0 +1,101 @@
+/**
+ * @file i2c_clock.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Adaptive bus clock driven by the port statistics
+ */
+
+#include <i2c_clock.h>
+#include <i2c_backend.h>
+
+static const uint32_t ladder[] = {100000, 200000, 400000, 600000, 800000, 1000000};
+
+#define LADDER_LEN  (sizeof(ladder) / sizeof(ladder[0]))
+
+// Next step up, 0 if already at the top
+static uint32_t step_up(const struct i2c_clock_tuner_t *t) {
+    for (size_t i = 0; i < LADDER_LEN; i++) {
+        if (ladder[i] > t->hz)
+            return ladder[i] < t->max_hz ? ladder[i] : t->max_hz;
+    }
+    return t->hz < t->max_hz ? t->max_hz : 0;
+}
+
+// Next step down, 0 if already at the bottom
+static uint32_t step_down(const struct i2c_clock_tuner_t *t) {
+    for (size_t i = LADDER_LEN; i-- > 0;) {
+        if (ladder[i] < t->hz)
+            return ladder[i] > t->min_hz ? ladder[i] : t->min_hz;
+    }
+    return t->hz > t->min_hz ? t->min_hz : 0;
+}
+
+static esp_err_t apply(struct i2c_clock_tuner_t *t, uint32_t hz) {
+    esp_err_t ret = i2c_set_clock(t->port, hz);
+    if (ret == ESP_OK) {
+        if (hz > t->hz)
+            t->ups++;
+        else
+            t->downs++;
+        t->hz = hz;
+    }
+    t->clean = 0;
+    i2c_stats_get_port(t->port, &t->last);  // Windows never straddle two clocks
+    return ret;
+}
+
+esp_err_t i2c_clock_tuner_init(struct i2c_clock_tuner_t *tuner, i2c_port_t port, uint32_t start_hz) {
+    *tuner = (struct i2c_clock_tuner_t) {
+        .port = port,
+        .min_hz = I2C_CLOCK_MIN_HZ,
+        .max_hz = I2C_CLOCK_MAX_HZ,
+        .window = I2C_CLOCK_WINDOW,
+        .max_errors_pm = I2C_CLOCK_MAX_ERRORS_PM,
+        .count_nacks = true,
+        .hold = I2C_CLOCK_HOLD,
+    };
+    esp_err_t ret = i2c_stats_get_port(port, &tuner->last);
+    if (ret != ESP_OK)
+        return ret;
+    ret = i2c_set_clock(port, start_hz);
+    if (ret == ESP_OK)
+        tuner->hz = start_hz;
+    return ret;
+}
+
+esp_err_t i2c_clock_tuner_step(struct i2c_clock_tuner_t *tuner) {
+    struct i2c_stats_t now;
+    if (i2c_stats_get_port(tuner->port, &now) != ESP_OK)
+        return ESP_ERR_NOT_SUPPORTED;
+    // Counters wrap, differences don't
+    uint32_t count = now.transactions - tuner->last.transactions;
+    uint64_t failed = (uint32_t) (now.timeouts - tuner->last.timeouts) + (uint32_t) (now.arb_lost - tuner->last.arb_lost) +
+        (uint32_t) (now.errors - tuner->last.errors);
+    if (tuner->count_nacks)
+        failed += (uint32_t) (now.nacks - tuner->last.nacks);
+
+    bool bad = failed * 1000 > (uint64_t) tuner->max_errors_pm * (count > tuner->window ? count : tuner->window);
+    if (count < tuner->window && !bad)
+        return ESP_OK;
+    tuner->last = now;
+
+    if (bad) {
+        uint32_t down = step_down(tuner);
+        if (tuner->hz == tuner->bad_hz)  // Failed again after a hold: wait longer next time
+            tuner->hold = tuner->hold * 2 < I2C_CLOCK_HOLD_MAX ? tuner->hold * 2 : I2C_CLOCK_HOLD_MAX;
+        else if (!tuner->bad_hz || tuner->hz < tuner->bad_hz)
+            tuner->bad_hz = tuner->hz;
+        tuner->clean = 0;
+        return down ? apply(tuner, down) : ESP_OK;
+    }
+
+    tuner->clean++;
+    if (tuner->bad_hz && tuner->hz >= tuner->bad_hz) {  // The retry held up: forget the failure
+        tuner->bad_hz = 0;
+        tuner->hold = I2C_CLOCK_HOLD;
+    }
+    uint32_t up = step_up(tuner);
+    if (!up || (tuner->bad_hz && up >= tuner->bad_hz && tuner->clean < tuner->hold))
+        return ESP_OK;
+    return apply(tuner, up);
+}
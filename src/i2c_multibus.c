@@ -0,0 +1,100 @@
+/**
+ * @file i2c_multibus.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Multi-bus context and device placement
+ */
+
+#include <string.h>
+#include <i2c_multibus.h>
+#include "i2c_os.h"
+
+#define BITS_PER_BYTE   (9)  // 8 data bits + ACK
+
+#ifndef I2C_MULTIBUS_CORES
+#ifdef ESP_PLATFORM
+#define I2C_MULTIBUS_CORES  portNUM_PROCESSORS
+#else
+#define I2C_MULTIBUS_CORES  (2)  // Ignored by the host threads anyway
+#endif
+#endif
+
+static int find(const struct i2c_multibus_t *mb, i2c_port_t port) {
+    for (size_t i = 0; i < mb->n; i++) {
+        if (mb->ports[i] == port)
+            return (int) i;
+    }
+    return -1;
+}
+
+static uint32_t cost_pm(const struct i2c_multibus_t *mb, size_t i, uint32_t bytes_per_s) {
+    return (uint32_t) ((uint64_t) bytes_per_s * BITS_PER_BYTE * 1000 / mb->clk_hz[i]);
+}
+
+static bool is_placed(const struct i2c_multibus_t *mb, size_t i, i2c_addr_t addr) {
+    return mb->placed[i][addr / 32] & (1UL << (addr % 32));
+}
+
+esp_err_t i2c_multibus_init(struct i2c_multibus_t *mb, const struct i2c_bus_t *confs, size_t n, bool async) {
+    if (!n || n > I2C_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+    memset(mb, 0, sizeof(*mb));
+    for (size_t i = 0; i < n; i++) {
+        if (confs[i].port >= I2C_NUM_MAX || confs[i].conf.mode != I2C_MODE_MASTER || find(mb, confs[i].port) >= 0)
+            return ESP_ERR_INVALID_ARG;
+        mb->ports[mb->n] = confs[i].port;
+        mb->clk_hz[mb->n] = confs[i].conf.master.clk_speed ? confs[i].conf.master.clk_speed : 100000;
+        mb->n++;
+    }
+
+    esp_err_t ret = ESP_OK;
+    mb->async = async;
+    for (; mb->inited < n && ret == ESP_OK; mb->inited += ret == ESP_OK)
+        ret = i2c_init(&confs[mb->inited]);
+    for (; mb->started < n && ret == ESP_OK && async; mb->started += ret == ESP_OK)
+        ret = i2c_async_start(confs[mb->started].port, (int) (mb->started % I2C_MULTIBUS_CORES));
+    if (ret != ESP_OK)
+        i2c_multibus_deinit(mb);  // Only what was set up above: a port already in use stays up
+    return ret;
+}
+
+void i2c_multibus_deinit(struct i2c_multibus_t *mb) {
+    for (size_t i = 0; i < mb->started; i++)
+        i2c_async_stop(mb->ports[i]);
+    for (size_t i = 0; i < mb->inited; i++)
+        i2c_deinit_port(mb->ports[i]);
+    memset(mb, 0, sizeof(*mb));
+}
+
+esp_err_t i2c_multibus_place(struct i2c_multibus_t *mb, struct i2c_dev_handle_t *dev, i2c_addr_t addr,
+        uint32_t bytes_per_s) {
+    int best = -1;
+    for (size_t i = 0; i < mb->n; i++) {
+        if (is_placed(mb, i, addr) || (best >= 0 && mb->load_pm[i] >= mb->load_pm[best]))
+            continue;  // Only probe ports that would win
+        struct i2c_dev_handle_t probe = {.port = mb->ports[i], .addr = addr};
+        if (i2c_probe(&probe, I2C_MULTIBUS_PROBE_MS) == ESP_OK)
+            best = (int) i;
+    }
+    if (best < 0)
+        return ESP_ERR_NOT_FOUND;
+    mb->placed[best][addr / 32] |= 1UL << (addr % 32);
+    mb->load_pm[best] += cost_pm(mb, best, bytes_per_s);
+    dev->port = mb->ports[best];
+    dev->addr = addr;
+    return ESP_OK;
+}
+
+void i2c_multibus_release(struct i2c_multibus_t *mb, const struct i2c_dev_handle_t *dev, uint32_t bytes_per_s) {
+    int i = find(mb, dev->port);
+    if (i < 0 || !is_placed(mb, i, dev->addr))
+        return;
+    mb->placed[i][dev->addr / 32] &= ~(1UL << (dev->addr % 32));
+    uint32_t cost = cost_pm(mb, i, bytes_per_s);
+    mb->load_pm[i] = mb->load_pm[i] > cost ? mb->load_pm[i] - cost : 0;
+}
+
+uint32_t i2c_multibus_load(const struct i2c_multibus_t *mb, i2c_port_t port) {
+    int i = find(mb, port);
+    return i < 0 ? 0 : mb->load_pm[i];
+}
@@ -0,0 +1,199 @@
+/**
+ * @file i2c_os.h
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Private OS abstraction: FreeRTOS on target, POSIX threads on host
+ */
+
+#ifndef __I2C_OS_H
+#define __I2C_OS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifndef I2C_THREAD_STACK
+#define I2C_THREAD_STACK    (2048)
+#endif
+
+#ifdef ESP_PLATFORM
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <esp_rom_sys.h>
+
+typedef struct {
+    SemaphoreHandle_t handle;
+    StaticSemaphore_t buf;
+} i2c_lock_t;
+
+#define I2C_LOCK_INITIALIZER    {.handle = NULL}
+
+static inline void i2c_lock_init(i2c_lock_t *lock) {
+    if (!lock->handle)
+        lock->handle = xSemaphoreCreateMutexStatic(&lock->buf);
+}
+
+static inline void i2c_lock_take(i2c_lock_t *lock) {
+    xSemaphoreTake(lock->handle, portMAX_DELAY);
+}
+
+static inline void i2c_lock_give(i2c_lock_t *lock) {
+    xSemaphoreGive(lock->handle);
+}
+
+typedef struct {
+    SemaphoreHandle_t handle;
+    StaticSemaphore_t buf;
+} i2c_sem_t;
+
+static inline void i2c_sem_init(i2c_sem_t *sem) {
+    sem->handle = xSemaphoreCreateCountingStatic(UINT32_MAX, 0, &sem->buf);
+}
+
+static inline void i2c_sem_give(i2c_sem_t *sem) {
+    xSemaphoreGive(sem->handle);
+}
+
+static inline void i2c_sem_take(i2c_sem_t *sem) {
+    xSemaphoreTake(sem->handle, portMAX_DELAY);
+}
+
+/**
+ * @brief start a worker
+ * @param core CPU to pin the worker to, -1 for no affinity
+ * @return true on success
+ */
+static inline bool i2c_thread_start(void (*fn)(void *), void *arg, const char *name, int prio, int core) {
+    return xTaskCreatePinnedToCore(fn, name, I2C_THREAD_STACK, arg, prio, NULL, core < 0 ? tskNO_AFFINITY : core) == pdPASS;
+}
+
+// Called by the worker as its very last statement
+static inline void i2c_thread_exit(void) {
+    vTaskDelete(NULL);
+}
+
+// At least one tick
+static inline void i2c_sleep_ms(uint32_t ms) {
+    TickType_t ticks = ms / portTICK_RATE_MS;
+    vTaskDelay(ticks ? ticks : 1);
+}
+
+// Busy-waits: meant for sub-tick delays
+static inline void i2c_delay_us(uint32_t us) {
+    esp_rom_delay_us(us);
+}
+
+// Monotonic microseconds since boot
+static inline int64_t i2c_time_us(void) {
+    return esp_timer_get_time();
+}
+
+#else
+
+#include <pthread.h>
+#include <time.h>
+
+typedef struct {
+    pthread_mutex_t mutex;
+} i2c_lock_t;
+
+#define I2C_LOCK_INITIALIZER    {.mutex = PTHREAD_MUTEX_INITIALIZER}
+
+static inline void i2c_lock_init(i2c_lock_t *lock) {
+    (void) lock;  // Statically initialized
+}
+
+static inline void i2c_lock_take(i2c_lock_t *lock) {
+    pthread_mutex_lock(&lock->mutex);
+}
+
+static inline void i2c_lock_give(i2c_lock_t *lock) {
+    pthread_mutex_unlock(&lock->mutex);
+}
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t count;
+} i2c_sem_t;
+
+static inline void i2c_sem_init(i2c_sem_t *sem) {
+    pthread_mutex_init(&sem->mutex, NULL);
+    pthread_cond_init(&sem->cond, NULL);
+    sem->count = 0;
+}
+
+static inline void i2c_sem_give(i2c_sem_t *sem) {
+    pthread_mutex_lock(&sem->mutex);
+    sem->count++;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->mutex);
+}
+
+static inline void i2c_sem_take(i2c_sem_t *sem) {
+    pthread_mutex_lock(&sem->mutex);
+    while (!sem->count)
+        pthread_cond_wait(&sem->cond, &sem->mutex);
+    sem->count--;
+    pthread_mutex_unlock(&sem->mutex);
+}
+
+struct i2c_thread_arg_t {
+    void (*fn)(void *);
+    void *arg;
+};
+
+static inline void *i2c_thread_entry(void *p) {
+    struct i2c_thread_arg_t args = *(struct i2c_thread_arg_t *) p;
+    free(p);
+    args.fn(args.arg);
+    return NULL;
+}
+
+/**
+ * @brief start a detached worker
+ * @param core ignored on host
+ * @return true on success
+ */
+static inline bool i2c_thread_start(void (*fn)(void *), void *arg, const char *name, int prio, int core) {
+    (void) name;
+    (void) prio;
+    (void) core;
+    pthread_t thread;
+    struct i2c_thread_arg_t *args = malloc(sizeof(*args));
+    if (!args)
+        return false;
+    *args = (struct i2c_thread_arg_t) {.fn = fn, .arg = arg};
+    if (pthread_create(&thread, NULL, i2c_thread_entry, args)) {
+        free(args);
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+static inline void i2c_thread_exit(void) {
+}
+
+static inline void i2c_sleep_ms(uint32_t ms) {
+    struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long) (ms % 1000) * 1000000};
+    nanosleep(&ts, NULL);
+}
+
+static inline void i2c_delay_us(uint32_t us) {
+    struct timespec ts = {.tv_sec = us / 1000000, .tv_nsec = (long) (us % 1000000) * 1000};
+    nanosleep(&ts, NULL);
+}
+
+static inline int64_t i2c_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#endif  // ESP_PLATFORM
+
+#endif  // __I2C_OS_H
@@ -0,0 +1,36 @@
+/**
+ * @file i2c_regcache.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Shadow register cache configuration. Lookups and updates happen in libi2c.c, under the port lock
+ */
+
+#include <string.h>
+#include <i2c_regcache.h>
+
+static void bit_assign(uint32_t *map, u8 reg, bool val) {
+    if (val)
+        map[reg / 32] |= 1UL << (reg % 32);
+    else
+        map[reg / 32] &= ~(1UL << (reg % 32));
+}
+
+void i2c_regcache_init(struct i2c_regcache_t *cache) {
+    memset(cache, 0, sizeof(*cache));
+}
+
+void i2c_regcache_set_policy(struct i2c_regcache_t *cache, u8 first, u8 last, u8 policy) {
+    for (unsigned reg = first; reg <= last; reg++) {
+        bit_assign(cache->cached, reg, policy != I2C_REG_VOLATILE);
+        bit_assign(cache->write_through, reg, policy == I2C_REG_WRITE_THROUGH);
+        bit_assign(cache->valid, reg, false);
+    }
+}
+
+void i2c_regcache_attach(struct i2c_dev_handle_t *dev, struct i2c_regcache_t *cache) {
+    dev->cache = cache;
+}
+
+void i2c_regcache_get_stats(const struct i2c_regcache_t *cache, struct i2c_regcache_stats_t *stats) {
+    *stats = cache->stats;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file i2c_regmap.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Slave-side register map. The engine announces the bank it reads in `reading` and checks it's still the
+ *  published one; the application never edits a bank announced that way
+ */
+
+#include <string.h>
+#include <i2c_regmap.h>
+#include "i2c_os.h"
+
+#define NO_BANK     (0)
+
+static const u8 *latch(struct i2c_regmap_t *map) {
+    unsigned bank;
+    do {  // A publish in between would have missed the announcement: announce the new bank instead
+        bank = __atomic_load_n(&map->front, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&map->reading, bank + 1, __ATOMIC_SEQ_CST);
+    } while (__atomic_load_n(&map->front, __ATOMIC_SEQ_CST) != bank);
+    return map->banks[bank];
+}
+
+static void release(struct i2c_regmap_t *map) {
+    __atomic_store_n(&map->reading, NO_BANK, __ATOMIC_SEQ_CST);
+}
+
+static bool is_writable(const struct i2c_regmap_t *map, unsigned reg) {
+    return reg < map->size && map->writable && (map->writable[reg / 32] & (1UL << (reg % 32)));
+}
+
+static void flush(struct i2c_regmap_t *map) {
+    if (map->wlen && map->on_write)
+        map->on_write(map, map->wreg, map->wbuf, map->wlen, map->arg);
+    map->wlen = 0;
+}
+
+esp_err_t i2c_regmap_init(struct i2c_regmap_t *map, u8 *bank0, u8 *bank1, size_t size) {
+    if (!size || size > I2C_REGMAP_SIZE_MAX)
+        return ESP_ERR_INVALID_ARG;
+    memset(map, 0, sizeof(*map));
+    map->banks[0] = bank0;
+    map->banks[1] = bank1;
+    map->size = size;
+    memcpy(bank1, bank0, size);
+    map->synced = true;
+    return ESP_OK;
+}
+
+u8 *i2c_regmap_edit(struct i2c_regmap_t *map) {
+    unsigned front = __atomic_load_n(&map->front, __ATOMIC_SEQ_CST);
+    unsigned back = 1 - front;
+    while (__atomic_load_n(&map->reading, __ATOMIC_SEQ_CST) == back + 1)
+        i2c_sleep_ms(1);
+    if (!map->synced) {
+        memcpy(map->banks[back], map->banks[front], map->size);
+        map->synced = true;
+    }
+    return map->banks[back];
+}
+
+void i2c_regmap_publish(struct i2c_regmap_t *map) {
+    unsigned front = __atomic_load_n(&map->front, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&map->front, 1 - front, __ATOMIC_SEQ_CST);
+    map->synced = false;
+}
+
+const u8 *i2c_regmap_front(const struct i2c_regmap_t *map) {
+    return map->banks[__atomic_load_n(&map->front, __ATOMIC_SEQ_CST)];
+}
+
+void i2c_regmap_start(struct i2c_regmap_t *map, u8 rw) {
+    flush(map);  // Writes before a repeated START
+    if (rw == WRITE_BIT) {
+        map->ptr_set = false;  // First written byte is the register pointer
+    } else {
+        map->snap = latch(map);
+    }
+}
+
+bool i2c_regmap_write(struct i2c_regmap_t *map, u8 data) {
+    if (!map->ptr_set) {
+        map->ptr = data;
+        map->ptr_set = true;
+        return true;
+    }
+    if (!is_writable(map, map->ptr))
+        return false;
+    if (map->wlen == I2C_REGMAP_WRITE_MAX || (map->wlen && (u8) (map->wreg + map->wlen) != map->ptr))
+        flush(map);
+    if (!map->wlen)
+        map->wreg = map->ptr;
+    map->wbuf[map->wlen++] = data;
+    map->ptr++;
+    return true;
+}
+
+u8 i2c_regmap_read(struct i2c_regmap_t *map) {
+    u8 reg = map->ptr++;
+    const u8 *bank = map->snap ? map->snap : i2c_regmap_front(map);
+    return reg < map->size ? bank[reg] : 0xff;
+}
+
+void i2c_regmap_stop(struct i2c_regmap_t *map) {
+    if (map->snap) {
+        map->snap = NULL;
+        release(map);
+    }
+    flush(map);  // After the release: the callback may edit and publish
+}
+
+// Simulated bus glue
+
+static bool sim_start(struct i2c_sim_dev_t *dev, u8 rw) {
+    i2c_regmap_start(dev->ctx, rw);
+    return true;
+}
+
+static bool sim_write(struct i2c_sim_dev_t *dev, u8 data) {
+    return i2c_regmap_write(dev->ctx, data);
+}
+
+static u8 sim_read(struct i2c_sim_dev_t *dev, bool ack) {
+    (void) ack;
+    return i2c_regmap_read(dev->ctx);
+}
+
+static void sim_stop(struct i2c_sim_dev_t *dev) {
+    i2c_regmap_stop(dev->ctx);
+}
+
+static const struct i2c_sim_ops_t sim_ops = {
+    .start = sim_start,
+    .write = sim_write,
+    .read = sim_read,
+    .stop = sim_stop,
+};
+
+struct i2c_sim_dev_t *i2c_regmap_sim_init(struct i2c_regmap_t *map, i2c_addr_t addr) {
+    map->sim = (struct i2c_sim_dev_t) {.addr = addr, .ops = &sim_ops, .ctx = map};
+    return &map->sim;
+}
+
+#ifdef ESP_PLATFORM
+
+struct serve_port_t {
+    i2c_port_t port;
+    struct i2c_regmap_t *map;
+    i2c_sem_t stopped;
+    volatile bool running;
+    volatile bool stopping;
+};
+
+static struct serve_port_t serving[I2C_NUM_MAX];
+
+static const char *worker_names[] = {"i2c_regmap_0", "i2c_regmap_1"};
+
+static void serve(void *arg) {
+    struct serve_port_t *s = arg;
+    struct i2c_regmap_t *map = s->map;
+    const TickType_t gap = pdMS_TO_TICKS(I2C_REGMAP_GAP_MS) + 1;  // Whole ticks: a 1-tick wait can end right away
+    u8 rx[1 + I2C_REGMAP_WRITE_MAX];
+    while (!s->stopping) {
+        int len = i2c_slave_read_buffer(s->port, rx, sizeof(rx), pdMS_TO_TICKS(I2C_REGMAP_POLL_MS));
+        if (len <= 0)
+            continue;
+        // A read returns whatever has arrived, not a transaction: the write goes on until the bus is idle
+        i2c_regmap_start(map, WRITE_BIT);
+        do {
+            for (int i = 0; i < len; i++)
+                i2c_regmap_write(map, rx[i]);  // The driver has ACKed everything already: rejected bytes are dropped
+        } while ((len = i2c_slave_read_buffer(s->port, rx, sizeof(rx), gap)) > 0);
+        i2c_regmap_stop(map);  // Written registers first, the callback may publish what the master reads next
+        // Queue the answer to the read that follows: the only copy, made once per pointer write
+        const u8 *bank = latch(map);
+        size_t n = map->ptr < map->size ? map->size - map->ptr : 0;
+        i2c_reset_tx_fifo(s->port);
+        if (n)
+            i2c_slave_write_buffer(s->port, (u8 *) bank + map->ptr, n < I2C_REGMAP_PRELOAD ? n : I2C_REGMAP_PRELOAD, 0);
+        release(map);
+    }
+    s->running = false;
+    i2c_sem_give(&s->stopped);
+    i2c_thread_exit();
+}
+
+esp_err_t i2c_regmap_serve(i2c_port_t port, struct i2c_regmap_t *map, int core) {
+    if (port >= I2C_NUM_MAX || !i2c_get_backend(port))
+        return ESP_ERR_INVALID_STATE;
+    struct serve_port_t *s = &serving[port];
+    if (s->running)
+        return ESP_ERR_INVALID_STATE;
+    i2c_sem_init(&s->stopped);
+    s->port = port;
+    s->map = map;
+    s->stopping = false;
+    s->running = true;
+    if (!i2c_thread_start(serve, s, worker_names[port % 2], I2C_REGMAP_PRIO, core)) {
+        s->running = false;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void i2c_regmap_serve_stop(i2c_port_t port) {
+    struct serve_port_t *s = &serving[port];
+    if (!s->running)
+        return;
+    s->stopping = true;
+    i2c_sem_take(&s->stopped);
+}
+
+#endif  // ESP_PLATFORM
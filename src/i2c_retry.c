@@ -0,0 +1,82 @@
+/**
+ * @file i2c_retry.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Retry policy and circuit breaker state machine. The retry loop itself is in libi2c.c, under the port lock
+ */
+
+#include <string.h>
+#include <i2c_retry.h>
+
+void i2c_retry_init(struct i2c_retry_t *policy) {
+    *policy = (struct i2c_retry_t) {
+        .attempts = I2C_RETRY_ATTEMPTS,
+        .backoff_ms = I2C_RETRY_BACKOFF_MS,
+        .backoff_max_ms = I2C_RETRY_BACKOFF_MAX,
+        .budget_ms = I2C_RETRY_BUDGET_MS,
+        .trip = I2C_RETRY_TRIP,
+        .open_ms = I2C_RETRY_OPEN_MS,
+        .open_max_ms = I2C_RETRY_OPEN_MAX_MS,
+        .seed = 0x9e3779b9,
+    };
+}
+
+void i2c_retry_attach(struct i2c_dev_handle_t *dev, struct i2c_retry_t *policy) {
+    if (policy) {
+        policy->seed ^= dev->addr * 0x01000193u;  // Devices failing together don't retry in lockstep
+        policy->open_period_ms = policy->open_ms;
+    }
+    dev->retry = policy;
+}
+
+bool i2c_retry_is_open(const struct i2c_dev_handle_t *dev) {
+    return dev->retry && dev->retry->open_until_us;
+}
+
+void i2c_retry_get_stats(const struct i2c_dev_handle_t *dev, struct i2c_retry_stats_t *stats) {
+    if (dev->retry)
+        *stats = dev->retry->stats;
+    else
+        memset(stats, 0, sizeof(*stats));
+}
+
+bool i2c_retry_admit(struct i2c_retry_t *policy, int64_t now_us, bool *probe) {
+    *probe = false;
+    if (!policy->open_until_us)
+        return true;
+    if (now_us < policy->open_until_us) {
+        policy->stats.rejected++;
+        return false;
+    }
+    *probe = true;  // Half-open: one attempt, its outcome closes or reopens the breaker
+    return true;
+}
+
+void i2c_retry_done(struct i2c_retry_t *policy, bool ok, int64_t now_us) {
+    if (ok) {
+        policy->failures = 0;
+        policy->open_until_us = 0;
+        policy->open_period_ms = policy->open_ms;
+        return;
+    }
+    policy->failures++;
+    if (!policy->trip || policy->failures < policy->trip)
+        return;
+    if (policy->open_until_us) {  // Failed probe: stay away longer
+        uint32_t next = policy->open_period_ms * 2;
+        policy->open_period_ms = next < policy->open_max_ms ? next : policy->open_max_ms;
+    }
+    policy->open_until_us = now_us + (int64_t) policy->open_period_ms * 1000;
+    policy->stats.trips++;
+}
+
+uint32_t i2c_retry_backoff(struct i2c_retry_t *policy, uint32_t retry) {
+    uint32_t delay = policy->backoff_ms << (retry < 16 ? retry : 16);
+    if (delay > policy->backoff_max_ms || delay < policy->backoff_ms)
+        delay = policy->backoff_max_ms;
+    policy->seed ^= policy->seed << 13;  // xorshift32
+    policy->seed ^= policy->seed >> 17;
+    policy->seed ^= policy->seed << 5;
+    delay = delay / 2 + policy->seed % (delay - delay / 2 + 1);
+    return delay ? delay : 1;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file i2c_scan.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Bus scanner and device registry
+ */
+
+#include <string.h>
+#include <i2c_scan.h>
+
+const struct i2c_fingerprint_t i2c_fingerprints[] = {
+    {.name = "bmp280", .addr_match = 0x76, .addr_mask = 0x7e, .reg = 0xd0, .mask = 0xff, .value = 0x58},
+    {.name = "bme280", .addr_match = 0x76, .addr_mask = 0x7e, .reg = 0xd0, .mask = 0xff, .value = 0x60},
+    {.name = "bmp180", .addr_match = 0x77, .addr_mask = 0x7f, .reg = 0xd0, .mask = 0xff, .value = 0x55},
+    {.name = "mpu6050", .addr_match = 0x68, .addr_mask = 0x7e, .reg = 0x75, .mask = 0x7e, .value = 0x68},
+    {.name = "ssd1306", .addr_match = 0x3c, .addr_mask = 0x7e, .flags = I2C_FP_ADDR_ONLY},
+    {.name = NULL},
+};
+
+static bool addr_matches(const struct i2c_fingerprint_t *fp, i2c_addr_t addr) {
+    return (addr & fp->addr_mask) == fp->addr_match;
+}
+
+// Id register matches are preferred over address-only ones, whatever the table order
+static const struct i2c_fingerprint_t *identify(const struct i2c_dev_handle_t *dev, const struct i2c_fingerprint_t *fps) {
+    const struct i2c_fingerprint_t *weak = NULL;
+    for (const struct i2c_fingerprint_t *fp = fps; fp->name; fp++) {
+        if (!addr_matches(fp, dev->addr))
+            continue;
+        if (fp->flags & I2C_FP_ADDR_ONLY) {
+            weak = weak ? weak : fp;
+            continue;
+        }
+        u8 id;
+        if (i2c_read_register(dev, fp->reg, &id, 1) == ESP_OK && (id & fp->mask) == fp->value)
+            return fp;
+    }
+    return weak;
+}
+
+esp_err_t i2c_scan(i2c_port_t port, struct i2c_registry_t *registry, const struct i2c_fingerprint_t *fps) {
+    memset(registry, 0, sizeof(*registry));
+    fps = fps ? fps : i2c_fingerprints;
+
+    // Presence first, with short timeouts: the whole space in a few milliseconds
+    for (i2c_addr_t addr = I2C_SCAN_FIRST; addr <= I2C_SCAN_LAST; addr++) {
+        struct i2c_dev_handle_t dev = {.port = port, .addr = addr};
+        esp_err_t ret = i2c_probe(&dev, I2C_PROBE_TIMEOUT_MS);
+        if (ret == ESP_FAIL)  // NACK: nobody there
+            continue;
+        if (ret != ESP_OK)
+            return ret;
+        registry->present[addr / 32] |= 1UL << (addr % 32);
+        registry->found++;
+    }
+
+    // Then identification, only for the devices that answered
+    for (i2c_addr_t addr = I2C_SCAN_FIRST; addr <= I2C_SCAN_LAST && registry->n < I2C_REGISTRY_MAX; addr++) {
+        if (!i2c_registry_present(registry, addr))
+            continue;
+        struct i2c_registry_entry_t *entry = &registry->devs[registry->n++];
+        entry->dev = (struct i2c_dev_handle_t) {.port = port, .addr = addr};
+        entry->fp = identify(&entry->dev, fps);
+    }
+    return ESP_OK;
+}
+
+const struct i2c_dev_handle_t *i2c_registry_find(const struct i2c_registry_t *registry, const char *name, size_t nth) {
+    for (size_t i = 0; i < registry->n; i++) {
+        const struct i2c_registry_entry_t *entry = &registry->devs[i];
+        if (entry->fp && !strcmp(entry->fp->name, name) && !nth--)
+            return &entry->dev;
+    }
+    return NULL;
+}
+
+bool i2c_registry_present(const struct i2c_registry_t *registry, i2c_addr_t addr) {
+    return addr < 128 && (registry->present[addr / 32] & (1UL << (addr % 32)));
+}
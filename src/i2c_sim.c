@@ -0,0 +1,234 @@
+/**
+ * @file i2c_sim.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief In-process simulated I2C bus backend
+ */
+
+#include <string.h>
+#include <i2c_sim.h>
+#include "i2c_os.h"
+
+#define SIM_DEFAULT_CLK     (100000)
+#define BITS_PER_BYTE       (9)  // 8 data bits + ACK
+#define BITS_PER_COND       (1)  // START, repeated START or STOP
+#define RECOVERY_PULSES     (9)
+#define FAULT_PERIOD        (4)  // Above the clock limit, one transaction in FAULT_PERIOD is NACKed
+
+struct sim_port_t {
+    struct i2c_sim_dev_t *devs;
+    uint32_t clk_speed;
+    uint32_t clk_limit;
+    uint32_t faults;
+    unsigned sda_hold;
+    bool realtime;
+    size_t max_transfer;
+    struct i2c_sim_stats_t stats;
+};
+
+static struct sim_port_t ports[I2C_NUM_MAX];
+
+static struct i2c_sim_dev_t *find_dev(struct sim_port_t *p, i2c_addr_t addr) {
+    for (struct i2c_sim_dev_t *dev = p->devs; dev; dev = dev->next) {
+        if (dev->addr == addr)
+            return dev;
+    }
+    return NULL;
+}
+
+static void account(struct sim_port_t *p, uint64_t bytes, uint64_t conds) {
+    uint32_t clk = p->clk_speed ? p->clk_speed : SIM_DEFAULT_CLK;
+    p->stats.bytes += bytes;
+    p->stats.bus_time_ns += (bytes * BITS_PER_BYTE + conds * BITS_PER_COND) * 1000000000ULL / clk;
+}
+
+static esp_err_t sim_init(const struct i2c_bus_t *conf) {
+    if (conf->conf.mode == I2C_MODE_MASTER)
+        ports[conf->port].clk_speed = conf->conf.master.clk_speed;
+    return ESP_OK;
+}
+
+static esp_err_t sim_deinit(i2c_port_t port) {
+    (void) port;
+    return ESP_OK;
+}
+
+static esp_err_t sim_run(struct sim_port_t *p, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n, uint32_t timeout_ms) {
+    struct i2c_sim_dev_t *dev = find_dev(p, addr);
+    esp_err_t ret = ESP_OK;
+    uint64_t bytes = 0, conds = 1;  // Final STOP
+
+    p->stats.transactions++;
+    if (p->sda_hold) {  // Nothing gets through, the controller gives up after timeout_ms
+        p->stats.bus_time_ns += timeout_ms * 1000000ULL;
+        return ESP_ERR_TIMEOUT;
+    }
+    if (!dev || (p->clk_limit && p->clk_speed > p->clk_limit && !(++p->faults % FAULT_PERIOD))) {  // Nobody ACKs the address
+        p->stats.nacks++;
+        account(p, 1, 2);
+        return ESP_FAIL;
+    }
+    for (size_t i = 0; i < n && ret == ESP_OK; i++) {
+        bool read = msgs[i].flags & I2C_MSG_READ;
+        if (!(msgs[i].flags & I2C_MSG_NOSTART)) {
+            conds++;
+            bytes++;
+            if (dev->ops->start && !dev->ops->start(dev, read ? READ_BIT : WRITE_BIT)) {
+                ret = ESP_FAIL;
+                break;
+            }
+        }
+        for (size_t j = 0; j < msgs[i].len; j++) {
+            bytes++;
+            if (read) {
+                bool ack = j < msgs[i].len - 1 || (i < n - 1 && (msgs[i + 1].flags & I2C_MSG_NOSTART));
+                msgs[i].buf[j] = dev->ops->read ? dev->ops->read(dev, ack) : 0xff;
+            } else if (dev->ops->write && !dev->ops->write(dev, msgs[i].buf[j])) {
+                ret = ESP_FAIL;
+                break;
+            }
+        }
+    }
+    if (dev->ops->stop)
+        dev->ops->stop(dev);
+    if (ret == ESP_FAIL)
+        p->stats.nacks++;
+    account(p, bytes, conds);
+    return ret;
+}
+
+// Bytes counted against max_transfer: all of them but the first one written, the register address or control byte
+static size_t payload(const struct i2c_msg_t *msgs, size_t n) {
+    size_t len = 0;
+    for (size_t i = 0; i < n; i++)
+        len += msgs[i].len;
+    if (n > 1 && msgs[0].len && !(msgs[0].flags & I2C_MSG_READ))
+        len--;
+    return len;
+}
+
+static esp_err_t sim_transfer(i2c_port_t port, i2c_addr_t addr, struct i2c_msg_t *msgs, size_t n, uint32_t timeout_ms) {
+    struct sim_port_t *p = &ports[port];
+    if (p->max_transfer && payload(msgs, n) > p->max_transfer)
+        return ESP_ERR_INVALID_SIZE;  // Refused by the adapter, nothing on the wire
+    uint64_t before = p->stats.bus_time_ns;
+    esp_err_t ret = sim_run(p, addr, msgs, n, timeout_ms);
+    if (p->realtime)  // Block like a driver waiting for its transaction to complete
+        i2c_delay_us((uint32_t) ((p->stats.bus_time_ns - before) / 1000));
+    return ret;
+}
+
+static size_t sim_max_transfer(i2c_port_t port) {
+    return ports[port].max_transfer;
+}
+
+static esp_err_t sim_recover(i2c_port_t port, unsigned *pulses) {
+    struct sim_port_t *p = &ports[port];
+    *pulses = p->sda_hold < RECOVERY_PULSES ? p->sda_hold : RECOVERY_PULSES;
+    p->sda_hold -= *pulses;
+    account(p, 0, *pulses + 1);  // Pulses and STOP
+    return p->sda_hold ? ESP_FAIL : ESP_OK;
+}
+
+static esp_err_t sim_set_clock(i2c_port_t port, uint32_t hz) {
+    if (!hz)
+        return ESP_ERR_INVALID_ARG;
+    ports[port].clk_speed = hz;
+    return ESP_OK;
+}
+
+const struct i2c_backend_t i2c_backend_sim = {
+    .name = "sim",
+    .init = sim_init,
+    .deinit = sim_deinit,
+    .transfer = sim_transfer,
+    .max_transfer = sim_max_transfer,
+    .set_clock = sim_set_clock,
+    .recover = sim_recover,
+};
+
+void i2c_sim_attach(i2c_port_t port, struct i2c_sim_dev_t *dev) {
+    dev->next = ports[port].devs;
+    ports[port].devs = dev;
+}
+
+void i2c_sim_detach(i2c_port_t port, struct i2c_sim_dev_t *dev) {
+    for (struct i2c_sim_dev_t **it = &ports[port].devs; *it; it = &(*it)->next) {
+        if (*it == dev) {
+            *it = dev->next;
+            dev->next = NULL;
+            return;
+        }
+    }
+}
+
+void i2c_sim_set_max_transfer(i2c_port_t port, size_t max) {
+    ports[port].max_transfer = max;
+}
+
+void i2c_sim_set_clock_limit(i2c_port_t port, uint32_t hz) {
+    ports[port].clk_limit = hz;
+    ports[port].faults = 0;
+}
+
+void i2c_sim_hold_sda(i2c_port_t port, unsigned pulses) {
+    ports[port].sda_hold = pulses;
+}
+
+void i2c_sim_set_realtime(i2c_port_t port, bool realtime) {
+    ports[port].realtime = realtime;
+}
+
+void i2c_sim_get_stats(i2c_port_t port, struct i2c_sim_stats_t *stats) {
+    *stats = ports[port].stats;
+}
+
+void i2c_sim_reset_stats(i2c_port_t port) {
+    memset(&ports[port].stats, 0, sizeof(ports[port].stats));
+}
+
+// Register file model
+
+static bool regs_start(struct i2c_sim_dev_t *dev, u8 rw) {
+    struct i2c_sim_regs_t *model = dev->ctx;
+    if (rw == WRITE_BIT)
+        model->ptr_set = false;  // First written byte is the register pointer
+    return true;
+}
+
+static bool regs_write(struct i2c_sim_dev_t *dev, u8 data) {
+    struct i2c_sim_regs_t *model = dev->ctx;
+    if (!model->ptr_set) {
+        model->ptr = data;
+        model->ptr_set = true;
+        return true;
+    }
+    u8 reg = model->ptr++;
+    model->regs[reg] = data;
+    if (model->on_write)
+        model->on_write(model, reg, data);
+    return true;
+}
+
+static u8 regs_read(struct i2c_sim_dev_t *dev, bool ack) {
+    (void) ack;
+    struct i2c_sim_regs_t *model = dev->ctx;
+    u8 reg = model->ptr++;
+    if (model->on_read)
+        model->on_read(model, reg);
+    return model->regs[reg];
+}
+
+static const struct i2c_sim_ops_t regs_ops = {
+    .start = regs_start,
+    .write = regs_write,
+    .read = regs_read,
+};
+
+struct i2c_sim_dev_t *i2c_sim_regs_init(struct i2c_sim_regs_t *model, i2c_addr_t addr) {
+    memset(model, 0, sizeof(*model));
+    model->dev.addr = addr;
+    model->dev.ops = &regs_ops;
+    model->dev.ctx = model;
+    return &model->dev;
+}
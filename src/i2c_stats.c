@@ -0,0 +1,154 @@
+/**
+ * @file i2c_stats.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Transaction statistics. Writers are serialized by the port lock, readers never take it: every counter is
+ *  a relaxed atomic, so recording costs a handful of uncontended increments
+ */
+
+#include <i2c_stats.h>
+
+#define COUNTERS    (sizeof(struct i2c_stats_t) / sizeof(uint32_t))
+
+uint32_t i2c_stats_percentile(const struct i2c_stats_t *stats, unsigned pct) {
+    uint64_t total = 0, seen = 0;
+    for (int i = 0; i < I2C_STATS_BUCKETS; i++)
+        total += stats->latency[i];
+    if (!total)
+        return 0;
+    uint64_t rank = (total * (pct > 100 ? 100 : pct) + 99) / 100;  // Ceiling, so that p100 is the slowest one
+    for (int i = 0; i < I2C_STATS_BUCKETS - 1; i++) {
+        seen += stats->latency[i];
+        if (seen >= rank && seen)
+            return 1UL << i;
+    }
+    return UINT32_MAX;
+}
+
+#if I2C_STATS
+
+/**
+ * @struct dev_slot_t
+ * @var dev_slot_t::tag
+ *  slave address + 1, 0 if the slot is free. Written once, under the port lock
+ */
+struct dev_slot_t {
+    uint32_t tag;
+    struct i2c_stats_t stats;
+};
+
+static struct i2c_stats_t port_stats[I2C_NUM_MAX];
+static struct dev_slot_t dev_stats[I2C_NUM_MAX][I2C_STATS_DEVICES];
+
+static inline void add(uint32_t *counter, uint32_t val) {
+    __atomic_fetch_add(counter, val, __ATOMIC_RELAXED);
+}
+
+static inline unsigned bucket(uint32_t us) {
+    unsigned b = us ? 32 - __builtin_clz(us) : 0;
+    return b < I2C_STATS_BUCKETS ? b : I2C_STATS_BUCKETS - 1;
+}
+
+static void account(struct i2c_stats_t *s, size_t bytes, esp_err_t ret, unsigned b) {
+    add(&s->transactions, 1);
+    add(&s->latency[b], 1);
+    switch (ret) {
+        case ESP_OK:
+            add(&s->bytes, (uint32_t) bytes);
+            break;
+        case ESP_FAIL:
+            add(&s->nacks, 1);
+            break;
+        case ESP_ERR_TIMEOUT:
+            add(&s->timeouts, 1);
+            break;
+        case I2C_ERR_ARB_LOST:
+            add(&s->arb_lost, 1);
+            break;
+        default:
+            add(&s->errors, 1);
+            break;
+    }
+}
+
+// Caller holds the port lock, so nobody else claims slots of this port in the meantime
+static struct i2c_stats_t *dev_slot(i2c_port_t port, i2c_addr_t addr, bool claim) {
+    struct dev_slot_t *slots = dev_stats[port];
+    uint32_t tag = (uint32_t) addr + 1;
+    for (int i = 0; i < I2C_STATS_DEVICES; i++) {
+        uint32_t t = __atomic_load_n(&slots[i].tag, __ATOMIC_ACQUIRE);
+        if (t == tag)
+            return &slots[i].stats;
+        if (!t) {
+            if (!claim)
+                return NULL;
+            __atomic_store_n(&slots[i].tag, tag, __ATOMIC_RELEASE);
+            return &slots[i].stats;
+        }
+    }
+    return NULL;
+}
+
+static void snapshot(const struct i2c_stats_t *s, struct i2c_stats_t *out) {
+    const uint32_t *src = (const uint32_t *) s;
+    uint32_t *dst = (uint32_t *) out;
+    for (size_t i = 0; i < COUNTERS; i++)
+        dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+}
+
+static void zero(struct i2c_stats_t *s) {
+    uint32_t *dst = (uint32_t *) s;
+    for (size_t i = 0; i < COUNTERS; i++)
+        __atomic_store_n(&dst[i], 0, __ATOMIC_RELAXED);
+}
+
+void i2c_stats_record(i2c_port_t port, i2c_addr_t addr, const struct i2c_msg_t *msgs, size_t n, esp_err_t ret, uint32_t us) {
+    if (port >= I2C_NUM_MAX)
+        return;
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; i++)
+        bytes += msgs[i].len;
+    unsigned b = bucket(us);
+    account(&port_stats[port], bytes, ret, b);
+    if (addr == I2C_STATS_PORT_ONLY)
+        return;
+    struct i2c_stats_t *s = dev_slot(port, addr, true);
+    if (s)
+        account(s, bytes, ret, b);
+}
+
+void i2c_stats_record_recovery(i2c_port_t port, i2c_addr_t addr) {
+    if (port >= I2C_NUM_MAX)
+        return;
+    add(&port_stats[port].recoveries, 1);
+    struct i2c_stats_t *s = addr == I2C_STATS_PORT_ONLY ? NULL : dev_slot(port, addr, false);
+    if (s)
+        add(&s->recoveries, 1);
+}
+
+esp_err_t i2c_stats_get_port(i2c_port_t port, struct i2c_stats_t *out) {
+    if (port >= I2C_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+    snapshot(&port_stats[port], out);
+    return ESP_OK;
+}
+
+esp_err_t i2c_stats_get_dev(const struct i2c_dev_handle_t *dev, struct i2c_stats_t *out) {
+    if (dev->port >= I2C_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+    const struct i2c_stats_t *s = dev_slot(dev->port, dev->addr, false);
+    if (!s)
+        return ESP_ERR_NOT_FOUND;
+    snapshot(s, out);
+    return ESP_OK;
+}
+
+void i2c_stats_reset(i2c_port_t port) {
+    if (port >= I2C_NUM_MAX)
+        return;
+    zero(&port_stats[port]);
+    for (int i = 0; i < I2C_STATS_DEVICES; i++)
+        zero(&dev_stats[port][i].stats);
+}
+
+#endif  // I2C_STATS
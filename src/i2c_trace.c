@@ -0,0 +1,182 @@
+/**
+ * @file i2c_trace.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Binary bus trace: ring writer, dump and parser. Attaching to a port happens in libi2c.c, under the port lock
+ */
+
+#include <string.h>
+#include <i2c_trace.h>
+
+#ifndef MIN
+#define MIN(a, b)       ((a) < (b) ? (a) : (b))
+#endif
+
+static const u8 magic[4] = {'I', '2', 'C', 'T'};
+
+static inline void put16(u8 *p, uint16_t v) {
+    p[0] = (u8) v;
+    p[1] = (u8) (v >> 8);
+}
+
+static inline void put32(u8 *p, uint32_t v) {
+    put16(p, (uint16_t) v);
+    put16(p + 2, (uint16_t) (v >> 16));
+}
+
+static inline uint16_t get16(const u8 *p) {
+    return (uint16_t) (p[0] | p[1] << 8);
+}
+
+static inline uint32_t get32(const u8 *p) {
+    return get16(p) | (uint32_t) get16(p + 2) << 16;
+}
+
+// Copy into the ring at a free-running offset, wrapping at most once
+static void ring_put(struct i2c_trace_t *t, size_t off, const u8 *src, size_t len) {
+    size_t at = off & t->mask, first = MIN(len, t->mask + 1 - at);
+    memcpy(t->buf + at, src, first);
+    memcpy(t->buf, src + first, len - first);
+}
+
+static void ring_get(const struct i2c_trace_t *t, size_t off, u8 *dst, size_t len) {
+    size_t at = off & t->mask, first = MIN(len, t->mask + 1 - at);
+    memcpy(dst, t->buf + at, first);
+    memcpy(dst + first, t->buf, len - first);
+}
+
+esp_err_t i2c_trace_init(struct i2c_trace_t *trace, u8 *buf, size_t size) {
+    if (size < I2C_TRACE_REC_LEN || (size & (size - 1)))
+        return ESP_ERR_INVALID_SIZE;
+    *trace = (struct i2c_trace_t) {.buf = buf, .mask = size - 1};
+    return ESP_OK;
+}
+
+u8 i2c_trace_err_result(esp_err_t ret) {
+    switch (ret) {
+        case ESP_OK:
+            return I2C_TRACE_OK;
+        case ESP_FAIL:
+            return I2C_TRACE_NACK;
+        case ESP_ERR_TIMEOUT:
+            return I2C_TRACE_TIMEOUT;
+        case I2C_ERR_ARB_LOST:
+            return I2C_TRACE_ARB_LOST;
+        default:
+            return I2C_TRACE_ERROR;
+    }
+}
+
+esp_err_t i2c_trace_result_err(u8 result) {
+    switch (result) {
+        case I2C_TRACE_OK:
+            return ESP_OK;
+        case I2C_TRACE_NACK:
+            return ESP_FAIL;
+        case I2C_TRACE_TIMEOUT:
+            return ESP_ERR_TIMEOUT;
+        case I2C_TRACE_ARB_LOST:
+            return I2C_ERR_ARB_LOST;
+        default:
+            return ESP_ERR_INVALID_RESPONSE;
+    }
+}
+
+void i2c_trace_record(struct i2c_trace_t *trace, i2c_port_t port, i2c_addr_t addr, const struct i2c_msg_t *msgs, size_t n,
+        esp_err_t ret, uint32_t ts_us, uint32_t dur_us) {
+    u8 hdr[I2C_TRACE_REC_LEN + I2C_TRACE_SEGS * I2C_TRACE_SEG_LEN];
+    u8 result = i2c_trace_err_result(ret);
+    size_t segs = MIN(n, I2C_TRACE_SEGS), size = I2C_TRACE_REC_LEN + segs * I2C_TRACE_SEG_LEN;
+    u8 captured[I2C_TRACE_SEGS];
+    for (size_t i = 0; i < segs; i++) {
+        bool valid = !(msgs[i].flags & I2C_MSG_READ) || result == I2C_TRACE_OK;  // A failed read left garbage
+        captured[i] = valid ? (u8) MIN(msgs[i].len, I2C_TRACE_PAYLOAD) : 0;
+        size += captured[i];
+    }
+    if (size > trace->mask + 1 || size > UINT16_MAX) {
+        trace->dropped++;
+        return;
+    }
+    while (trace->mask + 1 - (trace->head - trace->tail) < size) {  // Overwrite the oldest records
+        u8 len[2];
+        ring_get(trace, trace->tail, len, 2);
+        trace->tail += get16(len);
+        trace->records--;
+        trace->dropped++;
+    }
+
+    put16(hdr, (uint16_t) size);
+    put32(hdr + 2, ts_us);
+    put16(hdr + 6, (uint16_t) MIN(dur_us, UINT16_MAX));
+    hdr[8] = (u8) port;
+    hdr[9] = addr;
+    hdr[10] = result;
+    hdr[11] = (u8) segs;
+    for (size_t i = 0; i < segs; i++) {
+        u8 *seg = hdr + I2C_TRACE_REC_LEN + i * I2C_TRACE_SEG_LEN;
+        seg[0] = msgs[i].flags;
+        seg[1] = captured[i];
+        put16(seg + 2, (uint16_t) MIN(msgs[i].len, UINT16_MAX));
+    }
+    size_t off = trace->head;
+    ring_put(trace, off, hdr, I2C_TRACE_REC_LEN + segs * I2C_TRACE_SEG_LEN);
+    off += I2C_TRACE_REC_LEN + segs * I2C_TRACE_SEG_LEN;
+    for (size_t i = 0; i < segs; i++) {
+        ring_put(trace, off, msgs[i].buf, captured[i]);
+        off += captured[i];
+    }
+    trace->head = off;
+    trace->records++;
+}
+
+size_t i2c_trace_dump_size(const struct i2c_trace_t *trace) {
+    return I2C_TRACE_HDR_LEN + (trace->head - trace->tail);
+}
+
+size_t i2c_trace_dump(const struct i2c_trace_t *trace, u8 *out, size_t size) {
+    size_t len = i2c_trace_dump_size(trace);
+    if (size < len)
+        return 0;
+    memcpy(out, magic, sizeof(magic));
+    out[4] = I2C_TRACE_VERSION;
+    out[5] = I2C_TRACE_PAYLOAD;
+    out[6] = out[7] = 0;
+    ring_get(trace, trace->tail, out + I2C_TRACE_HDR_LEN, len - I2C_TRACE_HDR_LEN);
+    return len;
+}
+
+size_t i2c_trace_first(const u8 *data, size_t len) {
+    if (len < I2C_TRACE_HDR_LEN || memcmp(data, magic, sizeof(magic)) || data[4] != I2C_TRACE_VERSION)
+        return 0;
+    return I2C_TRACE_HDR_LEN;
+}
+
+bool i2c_trace_next(const u8 *data, size_t len, size_t *off, struct i2c_trace_rec_t *rec) {
+    if (len < I2C_TRACE_HDR_LEN || *off > len || len - *off < I2C_TRACE_REC_LEN)
+        return false;
+    const u8 *p = data + *off;
+    size_t size = get16(p), pos = I2C_TRACE_REC_LEN;
+    rec->ts_us = get32(p + 2);
+    rec->dur_us = get16(p + 6);
+    rec->port = p[8];
+    rec->addr = p[9];
+    rec->result = p[10];
+    rec->n = p[11];
+    if (size > len - *off || rec->n > I2C_TRACE_SEGS || size < pos + rec->n * I2C_TRACE_SEG_LEN)
+        return false;
+    size_t payload = pos + rec->n * I2C_TRACE_SEG_LEN;
+    for (size_t i = 0; i < rec->n; i++, pos += I2C_TRACE_SEG_LEN) {
+        struct i2c_trace_seg_t *seg = &rec->seg[i];
+        seg->flags = p[pos];
+        seg->captured = p[pos + 1];
+        seg->len = get16(p + pos + 2);
+        seg->data = p + payload;
+        if (seg->captured > seg->len || seg->captured > data[5])  // Never more than the segment, nor the dump's cap
+            return false;
+        payload += seg->captured;
+    }
+    if (payload != size)
+        return false;
+    *off += size;
+    return true;
+}
@@ -5,107 +5,623 @@
  * @brief I2C library and tools for ESP32 - ESP-IDF framework
  */
 
+#include <string.h>
 #include <libi2c.h>
+#include <i2c_backend.h>
+#include <i2c_regcache.h>
+#include <i2c_stats.h>
+#include <i2c_trace.h>
+#include <i2c_retry.h>
+#include "i2c_os.h"
 
-static bool selected_reg = false;
-static i2c_cmd_handle_t shared_cmd;
+#ifdef ESP_PLATFORM
+#define DEFAULT_BACKEND (&i2c_backend_esp)
+#else
+#define DEFAULT_BACKEND (&i2c_backend_sim)
+#endif
 
-struct i2c_bus_t tmp_conf;
+#define ADDR_SPACE      (128)  // 7-bit addresses
+
+#ifndef MIN
+#define MIN(a, b)       ((a) < (b) ? (a) : (b))
+#endif
+
+/**
+ * @struct port_ctx_t
+ * @brief per-port state. Everything is protected by lock, so ports never contend with each other
+ * @var port_ctx_t::pending
+ *  bitmap of the addresses with a register selected for the next write (i2c_select_register with WRITE_BIT)
+ * @var port_ctx_t::pending_reg
+ *  selected register, per address. Sent in the same transaction as the data
+ * @var port_ctx_t::trace
+ *  trace ring, NULL when not tracing
+ * @var port_ctx_t::recovery_cb
+ *  recovery observer, can be NULL
+ * @var port_ctx_t::atomic
+ *  a multi-transaction operation that nobody may interleave with is running: retry backoffs keep the lock
+ */
+struct port_ctx_t {
+    const struct i2c_backend_t *backend;
+    i2c_lock_t lock;
+    uint32_t pending[ADDR_SPACE / 32];
+    u8 pending_reg[ADDR_SPACE];
+    struct i2c_trace_t *trace;
+    i2c_recovery_cb_t recovery_cb;
+    void *recovery_arg;
+    bool atomic;
+};
+
+static struct port_ctx_t ports[I2C_NUM_MAX] = {
+    [0 ... I2C_NUM_MAX - 1] = {.lock = I2C_LOCK_INITIALIZER},
+};
 
 /**
  * @brief check if a pointer is null. Use in combination with assert()
  * @param ptr pointer, input argument
  * @return true if ptr is not null, false otherwise
  */
-static bool ptr_check(void *ptr) {
+static bool ptr_check(const void *ptr) {
     return ptr != NULL;
 }
 
-// static void i2c_master_init(void) {  // configuration structure contained is tmp_conf
-    
-// }
+static struct port_ctx_t *get_port(const struct i2c_dev_handle_t *dev) {
+    if (dev->port >= I2C_NUM_MAX || !ports[dev->port].backend)
+        return NULL;
+    return &ports[dev->port];
+}
+
+static bool pending_take(struct port_ctx_t *ctx, i2c_addr_t addr, u8 *reg) {
+    uint32_t bit = 1UL << (addr % 32);
+    if (!(ctx->pending[addr / 32] & bit))
+        return false;
+    ctx->pending[addr / 32] &= ~bit;
+    *reg = ctx->pending_reg[addr];
+    return true;
+}
+
+static void pending_set(struct port_ctx_t *ctx, i2c_addr_t addr, u8 reg) {
+    ctx->pending[addr / 32] |= 1UL << (addr % 32);
+    ctx->pending_reg[addr] = reg;
+}
+
+static void pending_clear(struct port_ctx_t *ctx, i2c_addr_t addr) {
+    ctx->pending[addr / 32] &= ~(1UL << (addr % 32));
+}
+
+// Register cache, caller holds the port lock
+
+static bool cache_bit(const uint32_t *map, u8 reg) {
+    return map[reg / 32] & (1UL << (reg % 32));
+}
+
+static void cache_forget(struct i2c_regcache_t *cache) {
+    if (cache)
+        memset(cache->valid, 0, sizeof(cache->valid));
+}
+
+// Whole range known: copy it out
+static bool cache_lookup(struct i2c_regcache_t *cache, u8 reg, u8 *data, size_t size) {
+    bool cacheable = true, known = true;
+    for (size_t i = 0; i < size; i++) {
+        u8 r = (u8) (reg + i);
+        cacheable = cacheable && cache_bit(cache->cached, r);
+        known = known && cache_bit(cache->valid, r);
+    }
+    if (!cacheable)
+        return false;
+    if (!known) {
+        cache->stats.misses++;
+        return false;
+    }
+    for (size_t i = 0; i < size; i++)
+        data[i] = cache->values[(u8) (reg + i)];
+    cache->stats.hits++;
+    return true;
+}
+
+static void cache_store(struct i2c_regcache_t *cache, u8 reg, const u8 *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        u8 r = (u8) (reg + i);
+        if (cache_bit(cache->cached, r)) {
+            cache->values[r] = data[i];
+            cache->valid[r / 32] |= 1UL << (r % 32);
+        }
+    }
+}
+
+// A register needs the bus unless it's cached, known, equal to the new value and not write-through
+static bool cache_needs_write(const struct i2c_regcache_t *cache, u8 reg, u8 value) {
+    return !cache_bit(cache->cached, reg) || !cache_bit(cache->valid, reg) ||
+        cache_bit(cache->write_through, reg) || cache->values[reg] != value;
+}
+
+// Largest payload per transaction on this port
+static size_t max_chunk(struct port_ctx_t *ctx, i2c_port_t port) {
+    size_t max = ctx->backend->max_transfer ? ctx->backend->max_transfer(port) : 0;
+    return max ? max : SIZE_MAX;
+}
+
+// Caller holds ctx->lock
+static esp_err_t recover_locked(struct port_ctx_t *ctx, i2c_port_t port, i2c_addr_t addr) {
+    struct i2c_recovery_event_t ev = {.port = port, .addr = addr};
+    int64_t start = i2c_time_us();
+    ev.result = ctx->backend->recover(port, &ev.pulses);
+    ev.duration_us = (uint32_t) (i2c_time_us() - start);
+#if I2C_STATS
+    i2c_stats_record_recovery(port, addr);
+#endif
+    if (ctx->recovery_cb)
+        ctx->recovery_cb(&ev, ctx->recovery_arg);
+    return ev.result;
+}
+
+// Caller holds ctx->lock. Every transaction goes through here, so this is where it's timed
+static esp_err_t backend_transfer(struct port_ctx_t *ctx, const struct i2c_dev_handle_t *dev, struct i2c_msg_t *msgs, size_t n,
+        uint32_t timeout_ms, i2c_addr_t stats_addr) {
+#if I2C_STATS || I2C_TRACE
+    int64_t start = i2c_time_us();
+    esp_err_t ret = ctx->backend->transfer(dev->port, dev->addr, msgs, n, timeout_ms);
+    uint32_t us = (uint32_t) (i2c_time_us() - start);
+#if I2C_STATS
+    i2c_stats_record(dev->port, stats_addr, msgs, n, ret, us);
+#endif
+#if I2C_TRACE
+    if (ctx->trace)
+        i2c_trace_record(ctx->trace, dev->port, dev->addr, msgs, n, ret, (uint32_t) start, us);
+#endif
+#else
+    esp_err_t ret = ctx->backend->transfer(dev->port, dev->addr, msgs, n, timeout_ms);
+#endif
+    (void) stats_addr;  // Unused with I2C_STATS=0
+    // A timeout usually means a slave is holding SDA: free the bus now, so that the next caller doesn't wait too
+    if (ret == ESP_ERR_TIMEOUT && ctx->backend->recover)
+        recover_locked(ctx, dev->port, dev->addr);
+    return ret;
+}
+
+// Failures a second attempt can fix: the device was busy, the bus was stuck or taken
+static bool retryable(esp_err_t ret) {
+    return ret == ESP_FAIL || ret == ESP_ERR_TIMEOUT || ret == I2C_ERR_ARB_LOST;
+}
+
+// Caller holds ctx->lock. Applies the device's retry policy and circuit breaker, if any. The lock is released
+// while backing off, unless ctx->atomic: a failing device doesn't keep the port from the healthy ones
+static esp_err_t policy_transfer(struct port_ctx_t *ctx, const struct i2c_dev_handle_t *dev, struct i2c_msg_t *msgs, size_t n,
+        uint32_t timeout_ms) {
+    struct i2c_retry_t *policy = dev->retry;
+    if (!policy)
+        return backend_transfer(ctx, dev, msgs, n, timeout_ms, dev->addr);
+    bool probe;
+    int64_t start = i2c_time_us();
+    if (!i2c_retry_admit(policy, start, &probe))
+        return I2C_ERR_CIRCUIT_OPEN;  // No bus time for a device that keeps failing
+    uint32_t attempts = probe || !policy->attempts ? 1 : policy->attempts;
+    esp_err_t ret = backend_transfer(ctx, dev, msgs, n, timeout_ms, dev->addr);
+    for (uint32_t retry = 0; retryable(ret) && retry + 1 < attempts; retry++) {
+        uint32_t delay = i2c_retry_backoff(policy, retry);
+        int64_t used_ms = (i2c_time_us() - start) / 1000 + delay;
+        if (used_ms >= policy->budget_ms)
+            break;
+        if (ctx->atomic) {
+            i2c_sleep_ms(delay);
+        } else {
+            i2c_lock_give(&ctx->lock);
+            i2c_sleep_ms(delay);
+            i2c_lock_take(&ctx->lock);
+            if (!ctx->backend)  // Deinitialized meanwhile
+                return ESP_ERR_INVALID_STATE;
+        }
+        policy->stats.retries++;
+        // Retries only get what's left of the budget, so the tail stays bounded
+        ret = backend_transfer(ctx, dev, msgs, n, MIN(timeout_ms, policy->budget_ms - (uint32_t) used_ms), dev->addr);
+    }
+    if (retryable(ret))
+        policy->stats.exhausted++;
+    i2c_retry_done(policy, !retryable(ret), i2c_time_us());
+    return ret;
+}
+
+// Caller holds ctx->lock
+static esp_err_t port_transfer(struct port_ctx_t *ctx, const struct i2c_dev_handle_t *dev, struct i2c_msg_t *msgs, size_t n) {
+    return policy_transfer(ctx, dev, msgs, n, dev->timeout_ms ? dev->timeout_ms : I2C_DEFAULT_TIMEOUT_MS);
+}
+
+esp_err_t i2c_init(const struct i2c_bus_t *conf) {
+    assert(ptr_check(conf));
+    assert(conf->port < I2C_NUM_MAX);
+    struct port_ctx_t *ctx = &ports[conf->port];  // Each port has its own context: no shared state between them
+    const struct i2c_backend_t *backend = conf->backend ? conf->backend : DEFAULT_BACKEND;
+    i2c_lock_init(&ctx->lock);
+    i2c_lock_take(&ctx->lock);
+    memset(ctx->pending, 0, sizeof(ctx->pending));
+    esp_err_t ret = backend->init(conf);
+    ctx->backend = ret == ESP_OK ? backend : NULL;
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
+
+const struct i2c_backend_t *i2c_get_backend(i2c_port_t port) {
+    if (port >= I2C_NUM_MAX)
+        return NULL;
+    return ports[port].backend;
+}
 
-// static void i2c_slave_init(void) {  // configuration structure contained is tmp_conf
+esp_err_t i2c_transfer(const struct i2c_dev_handle_t *dev, struct i2c_msg_t *msgs, size_t n) {
+    assert(ptr_check(dev));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    i2c_lock_take(&ctx->lock);
+    esp_err_t ret = port_transfer(ctx, dev, msgs, n);
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
 
-// }
+esp_err_t i2c_set_clock(i2c_port_t port, uint32_t hz) {
+    if (port >= I2C_NUM_MAX || !ports[port].backend)
+        return ESP_ERR_INVALID_STATE;
+    struct port_ctx_t *ctx = &ports[port];
+    if (!ctx->backend->set_clock)
+        return ESP_ERR_NOT_SUPPORTED;
+    i2c_lock_take(&ctx->lock);
+    esp_err_t ret = ctx->backend->set_clock(port, hz);
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
 
-void i2c_init(const struct i2c_bus_t *conf) {
-    tmp_conf = *conf;
-    // if (tmp_conf.esp_idf_conf.mode == I2C_MODE_MASTER) {
-    //     i2c_master_init();
-    // }
-    // else if (tmp_conf.esp_idf_conf.mode == I2C_MODE_SLAVE) {
-    //     i2c_slave_init();
-    // }
-    // else {  // Neither master nor slave are set. Or both master and slave are set to true.
-    //     return;
-    // }
-    i2c_param_config(tmp_conf.port, &(tmp_conf.conf));
-    i2c_driver_install(tmp_conf.port, tmp_conf.conf.mode, tmp_conf.rx, tmp_conf.tx, 0);
+esp_err_t i2c_transfer_timeout(const struct i2c_dev_handle_t *dev, struct i2c_msg_t *msgs, size_t n, uint32_t timeout_ms) {
+    assert(ptr_check(dev));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    i2c_lock_take(&ctx->lock);
+    esp_err_t ret = policy_transfer(ctx, dev, msgs, n, timeout_ms);
+    i2c_lock_give(&ctx->lock);
+    return ret;
 }
 
-esp_err_t i2c_read_bytes(const struct i2c_dev_handle_t *dev, u8 *data, u8 size) {
+esp_err_t i2c_bus_recover(i2c_port_t port) {
+    if (port >= I2C_NUM_MAX || !ports[port].backend)
+        return ESP_ERR_INVALID_STATE;
+    struct port_ctx_t *ctx = &ports[port];
+    if (!ctx->backend->recover)
+        return ESP_ERR_NOT_SUPPORTED;
+    i2c_lock_take(&ctx->lock);
+    esp_err_t ret = recover_locked(ctx, port, I2C_ADDR_NONE);
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
+
+void i2c_set_recovery_callback(i2c_port_t port, i2c_recovery_cb_t cb, void *arg) {
+    if (port >= I2C_NUM_MAX)
+        return;
+    if (!ports[port].backend) {  // Before i2c_init: no transaction to race with, and no lock yet on target
+        ports[port].recovery_cb = cb;
+        ports[port].recovery_arg = arg;
+        return;
+    }
+    i2c_lock_take(&ports[port].lock);
+    ports[port].recovery_cb = cb;
+    ports[port].recovery_arg = arg;
+    i2c_lock_give(&ports[port].lock);
+}
+
+esp_err_t i2c_read_bytes(const struct i2c_dev_handle_t *dev, u8 *data, size_t size) {
+    assert(ptr_check(dev));
     assert(size);
     assert(ptr_check(data));
-    selected_reg = false;
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | READ_BIT, ACK_CHECK_EN);
-    if (size > 1) {
-        i2c_master_read(cmd, data, size - 1, ACK_VAL);
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    esp_err_t ret = ESP_OK;
+    i2c_lock_take(&ctx->lock);
+    pending_clear(ctx, dev->addr);
+    size_t chunk = max_chunk(ctx, dev->port);
+    for (size_t off = 0; off < size && ret == ESP_OK; off += chunk) {
+        struct i2c_msg_t msg = {.buf = data + off, .len = MIN(chunk, size - off), .flags = I2C_MSG_READ};
+        ret = port_transfer(ctx, dev, &msg, 1);
     }
-    i2c_master_read_byte(cmd, data + size - 1, NACK_VAL);
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(dev->port, cmd, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
+    i2c_lock_give(&ctx->lock);
     return ret;
 }
 
-u8 i2c_read_byte(const struct i2c_dev_handle_t *dev) {  // dev pointer integrity delegated to i2c_read_bytes
+esp_err_t i2c_read_byte(const struct i2c_dev_handle_t *dev, u8 *data) {  // pointer integrity checks delegated to i2c_read_bytes
     u8 buf;
-    i2c_read_bytes(dev, &buf, 1);
-    return buf;
+    esp_err_t ret = i2c_read_bytes(dev, &buf, 1);
+    if (ret == ESP_OK)
+        *data = buf;
+    return ret;
 }
 
-esp_err_t i2c_write_bytes(const struct i2c_dev_handle_t *dev, const u8 *data, u8 size) {
+esp_err_t i2c_write_bytes(const struct i2c_dev_handle_t *dev, const u8 *data, size_t size) {
     assert(ptr_check(dev));
     assert(size);
-    i2c_cmd_handle_t cmd;
-    if (!selected_reg) {
-        cmd = i2c_cmd_link_create();
-        i2c_master_start(cmd);
-        i2c_master_write_byte(cmd, (dev->addr << 1) | WRITE_BIT, ACK_CHECK_EN);
-    } else {
-        cmd = shared_cmd;
-        selected_reg = false;
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    struct i2c_msg_t msgs[2];
+    esp_err_t ret = ESP_OK;
+    u8 reg;
+    i2c_lock_take(&ctx->lock);
+    cache_forget(dev->cache);
+    bool selected = pending_take(ctx, dev->addr, &reg);
+    size_t chunk = max_chunk(ctx, dev->port);
+    for (size_t off = 0; off < size && ret == ESP_OK; off += chunk) {
+        size_t n = 0;
+        if (selected) {  // Register address and data travel in the same transaction
+            msgs[n++] = (struct i2c_msg_t) {.buf = &reg, .len = 1, .flags = I2C_MSG_WRITE};
+        }
+        msgs[n] = (struct i2c_msg_t) {.buf = (u8 *) data + off, .len = MIN(chunk, size - off), .flags = I2C_MSG_WRITE};
+        if (n)
+            msgs[n].flags |= I2C_MSG_NOSTART;
+        ret = port_transfer(ctx, dev, msgs, n + 1);
     }
-    i2c_master_write(cmd, data, size, ACK_CHECK_EN);
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(dev->port, cmd, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(cmd);
+    i2c_lock_give(&ctx->lock);
     return ret;
 }
 
 esp_err_t i2c_write_byte(const struct i2c_dev_handle_t *dev, u8 data) {  // pointer integrity check delegated to i2c_write_bytes
-    return i2c_write_bytes(dev, &data, 1);    
+    return i2c_write_bytes(dev, &data, 1);
 }
 
 // rw is needed to distinguish between read and write operations,
 // because write is not auto-incremented, whreas read allows burst-read
 void i2c_select_register(const struct i2c_dev_handle_t *dev, u8 reg, u8 rw) {
     assert(ptr_check(dev));
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | WRITE_BIT, ACK_CHECK_EN);
-    i2c_master_write_byte(cmd, reg, ACK_CHECK_EN);
-
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return;
+    i2c_lock_take(&ctx->lock);
     if (rw == READ_BIT) {
-        i2c_master_stop(cmd);
-        esp_err_t ret = i2c_master_cmd_begin(dev->port, cmd, 1000 / portTICK_RATE_MS);
-        i2c_cmd_link_delete(cmd);
+        struct i2c_msg_t msg = {.buf = &reg, .len = 1, .flags = I2C_MSG_WRITE};
+        pending_clear(ctx, dev->addr);
+        port_transfer(ctx, dev, &msg, 1);
     } else {
-        shared_cmd = cmd;
+        pending_set(ctx, dev->addr, reg);
+    }
+    i2c_lock_give(&ctx->lock);
+}
+
+// Caller holds ctx->lock
+static esp_err_t read_register_locked(struct port_ctx_t *ctx, const struct i2c_dev_handle_t *dev, u8 reg, u8 *data, size_t size) {
+    esp_err_t ret = ESP_OK;
+    if (dev->cache && cache_lookup(dev->cache, reg, data, size))
+        return ESP_OK;
+    size_t chunk = max_chunk(ctx, dev->port);
+    for (size_t off = 0; off < size && ret == ESP_OK; off += chunk) {
+        u8 chunk_reg = (u8) (reg + off);
+        struct i2c_msg_t msgs[2] = {
+            {.buf = &chunk_reg, .len = 1, .flags = I2C_MSG_WRITE},
+            {.buf = data + off, .len = MIN(chunk, size - off), .flags = I2C_MSG_READ},  // Repeated START, no STOP in between
+        };
+        ret = port_transfer(ctx, dev, msgs, 2);
     }
+    if (dev->cache && ret == ESP_OK)
+        cache_store(dev->cache, reg, data, size);
+    return ret;
+}
+
+// Caller holds ctx->lock
+static esp_err_t write_register_locked(struct port_ctx_t *ctx, const struct i2c_dev_handle_t *dev, u8 reg, const u8 *data, size_t size) {
+    esp_err_t ret = ESP_OK;
+    size_t first = 0, last = size - 1;
+    if (dev->cache) {  // Trim the registers that already hold their value
+        while (first < size && !cache_needs_write(dev->cache, (u8) (reg + first), data[first]))
+            first++;
+        while (last > first && !cache_needs_write(dev->cache, (u8) (reg + last), data[last]))
+            last--;
+        if (first == size) {
+            dev->cache->stats.suppressed++;
+            return ESP_OK;
+        }
+        dev->cache->stats.writes++;
+    }
+    size_t chunk = max_chunk(ctx, dev->port);
+    for (size_t off = first; off <= last && ret == ESP_OK; off += chunk) {
+        u8 chunk_reg = (u8) (reg + off);
+        struct i2c_msg_t msgs[2] = {
+            {.buf = &chunk_reg, .len = 1, .flags = I2C_MSG_WRITE},
+            {.buf = (u8 *) data + off, .len = MIN(chunk, last + 1 - off), .flags = I2C_MSG_WRITE | I2C_MSG_NOSTART},
+        };
+        ret = port_transfer(ctx, dev, msgs, 2);
+    }
+    if (dev->cache) {
+        if (ret == ESP_OK)
+            cache_store(dev->cache, reg, data, size);
+        else
+            cache_forget(dev->cache);  // Partially written, who knows
+    }
+    return ret;
+}
+
+esp_err_t i2c_read_register(const struct i2c_dev_handle_t *dev, u8 reg, u8 *data, size_t size) {
+    assert(ptr_check(dev));
+    assert(size);
+    assert(ptr_check(data));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    i2c_lock_take(&ctx->lock);
+    pending_clear(ctx, dev->addr);
+    esp_err_t ret = read_register_locked(ctx, dev, reg, data, size);
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
 
-    selected_reg = true;
-}
\ No newline at end of file
+esp_err_t i2c_write_register(const struct i2c_dev_handle_t *dev, u8 reg, const u8 *data, size_t size) {
+    assert(ptr_check(dev));
+    assert(size);
+    assert(ptr_check(data));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    i2c_lock_take(&ctx->lock);
+    pending_clear(ctx, dev->addr);
+    esp_err_t ret = write_register_locked(ctx, dev, reg, data, size);
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
+
+// Read and write under the same lock hold: nobody else can touch the register in between
+esp_err_t i2c_update_bits(const struct i2c_dev_handle_t *dev, u8 reg, u8 mask, u8 value) {
+    assert(ptr_check(dev));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    u8 old;
+    i2c_lock_take(&ctx->lock);
+    ctx->atomic = true;
+    pending_clear(ctx, dev->addr);
+    esp_err_t ret = read_register_locked(ctx, dev, reg, &old, 1);  // From the shadow copy when known
+    if (ret == ESP_OK) {
+        u8 val = (old & ~mask) | (value & mask);
+        if (val != old || (dev->cache && cache_bit(dev->cache->write_through, reg)))
+            ret = write_register_locked(ctx, dev, reg, &val, 1);
+        else if (dev->cache)
+            dev->cache->stats.suppressed++;
+    }
+    ctx->atomic = false;
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
+
+void i2c_retry_reset(const struct i2c_dev_handle_t *dev) {
+    assert(ptr_check(dev));
+    if (!dev->retry)
+        return;
+    struct port_ctx_t *ctx = get_port(dev);
+    if (ctx)
+        i2c_lock_take(&ctx->lock);
+    i2c_retry_done(dev->retry, true, 0);
+    if (ctx)
+        i2c_lock_give(&ctx->lock);
+}
+
+void i2c_regcache_invalidate(const struct i2c_dev_handle_t *dev) {
+    assert(ptr_check(dev));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx) {
+        cache_forget(dev->cache);
+        return;
+    }
+    i2c_lock_take(&ctx->lock);
+    cache_forget(dev->cache);
+    i2c_lock_give(&ctx->lock);
+}
+
+esp_err_t i2c_writev(const struct i2c_dev_handle_t *dev, const struct i2c_iovec_t *iov, size_t n) {
+    assert(ptr_check(dev));
+    assert(ptr_check(iov));
+    if (!n || n > I2C_IOV_MAX)
+        return ESP_ERR_INVALID_ARG;
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    struct i2c_msg_t msgs[I2C_IOV_MAX];
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        msgs[i] = (struct i2c_msg_t) {.buf = (u8 *) iov[i].base, .len = iov[i].len, .flags = I2C_MSG_WRITE};
+        if (i)
+            msgs[i].flags |= I2C_MSG_NOSTART;
+        total += iov[i].len;
+    }
+    esp_err_t ret = ESP_ERR_INVALID_SIZE;
+    i2c_lock_take(&ctx->lock);
+    pending_clear(ctx, dev->addr);
+    cache_forget(dev->cache);
+    size_t prefix = n > 1 && iov[0].len == 1 ? 1 : 0;  // Leading address or control byte, not payload
+    if (total - prefix <= max_chunk(ctx, dev->port))
+        ret = port_transfer(ctx, dev, msgs, n);
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
+
+esp_err_t i2c_probe(const struct i2c_dev_handle_t *dev, uint32_t timeout_ms) {
+    assert(ptr_check(dev));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    struct i2c_msg_t msg = {.buf = NULL, .len = 0, .flags = I2C_MSG_WRITE};
+    i2c_lock_take(&ctx->lock);
+    esp_err_t ret = backend_transfer(ctx, dev, &msg, 1, timeout_ms, I2C_STATS_PORT_ONLY);  // A scan would fill the device slots
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
+
+esp_err_t i2c_trace_start(i2c_port_t port, struct i2c_trace_t *trace) {
+    assert(ptr_check(trace));
+#if I2C_TRACE
+    if (port >= I2C_NUM_MAX || !ports[port].backend)
+        return ESP_ERR_INVALID_STATE;
+    i2c_lock_take(&ports[port].lock);
+    ports[port].trace = trace;
+    i2c_lock_give(&ports[port].lock);
+    return ESP_OK;
+#else
+    (void) port;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void i2c_trace_stop(i2c_port_t port) {
+    if (port >= I2C_NUM_MAX || !ports[port].backend)  // Not initialized: no lock yet, and i2c_deinit cleared trace
+        return;
+    i2c_lock_take(&ports[port].lock);  // Once we have it, no transaction is writing into the ring
+    ports[port].trace = NULL;
+    i2c_lock_give(&ports[port].lock);
+}
+
+esp_err_t i2c_write_stream(const struct i2c_dev_handle_t *dev, const u8 *prefix, size_t prefix_len,
+        i2c_producer_t producer, void *arg) {
+    assert(ptr_check(dev));
+    assert(ptr_check(producer));
+    struct port_ctx_t *ctx = get_port(dev);
+    if (!ctx)
+        return ESP_ERR_INVALID_STATE;
+    u8 buf[I2C_STREAM_CHUNK];
+    esp_err_t ret = ESP_OK;
+    i2c_lock_take(&ctx->lock);
+    pending_clear(ctx, dev->addr);
+    cache_forget(dev->cache);
+    size_t max = max_chunk(ctx, dev->port), extra = prefix_len > 1 ? prefix_len - 1 : 0;  // Only 1 byte is free
+    size_t chunk = max > extra ? MIN(max - extra, sizeof(buf)) : 0;
+    size_t len;
+    if (!chunk)
+        ret = ESP_ERR_INVALID_SIZE;
+    while (ret == ESP_OK && (len = producer(buf, chunk, arg))) {  // No chunk is pulled after a failure: it'd be lost
+        if (len > chunk) {  // Overflowed buf, or more than the adapter takes: don't send a truncated chunk
+            ret = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+        struct i2c_msg_t msgs[2];
+        size_t n = 0;
+        if (prefix_len) {
+            msgs[n++] = (struct i2c_msg_t) {.buf = (u8 *) prefix, .len = prefix_len, .flags = I2C_MSG_WRITE};
+        }
+        msgs[n] = (struct i2c_msg_t) {.buf = buf, .len = len, .flags = I2C_MSG_WRITE};
+        if (n)
+            msgs[n].flags |= I2C_MSG_NOSTART;
+        ret = port_transfer(ctx, dev, msgs, n + 1);
+    }
+    i2c_lock_give(&ctx->lock);
+    return ret;
+}
+
+esp_err_t i2c_deinit_port(i2c_port_t port) {
+    if (port >= I2C_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+    struct port_ctx_t *ctx = &ports[port];
+    if (!ctx->backend)
+        return ESP_ERR_INVALID_STATE;
+    i2c_lock_take(&ctx->lock);
+    ctx->backend->deinit(port);
+    ctx->backend = NULL;
+    ctx->trace = NULL;
+    i2c_lock_give(&ctx->lock);
+    return ESP_OK;
+}
+
+void i2c_deinit(void) {
+    for (int port = 0; port < I2C_NUM_MAX; port++)
+        i2c_deinit_port((i2c_port_t) port);
+}
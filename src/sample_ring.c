@@ -0,0 +1,95 @@
+/**
+ * @file sample_ring.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Lock-free single-producer/multi-consumer sample ring
+ */
+
+#include <sample_ring.h>
+#include <string.h>
+
+#define MASK    (SAMPLE_RING_SIZE - 1)
+#define WRITING (0x80000000u)  // Xor-ed into seq while a slot is written: matches no sample a reader can expect
+
+_Static_assert((SAMPLE_RING_SIZE & MASK) == 0, "SAMPLE_RING_SIZE must be a power of 2");
+
+void sample_ring_init(struct sample_ring_t *ring) {
+    memset(ring, 0, sizeof(*ring));
+}
+
+// Per-slot seqlock: readers copy the slot and accept it if seq didn't change in the meantime
+void sample_ring_push(struct sample_ring_t *ring, const struct sample_t *sample) {
+    uint32_t idx = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);  // Single producer: nobody else writes it
+    uint32_t slot = idx & MASK;
+
+    __atomic_store_n(&ring->seq[slot], (idx + 1) ^ WRITING, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    ring->slots[slot] = *sample;
+    __atomic_store_n(&ring->seq[slot], idx + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head, idx + 1, __ATOMIC_RELEASE);
+}
+
+void sample_ring_reader_init(struct sample_ring_t *ring, struct sample_reader_t *reader) {
+    reader->next = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    reader->lost = 0;
+}
+
+bool sample_ring_read(struct sample_ring_t *ring, struct sample_reader_t *reader, struct sample_t *sample) {
+    while (true) {
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (reader->next == head)
+            return false;
+        if (head - reader->next > SAMPLE_RING_SIZE) {  // Overrun: jump to the oldest sample still there
+            reader->lost += head - reader->next - SAMPLE_RING_SIZE;
+            reader->next = head - SAMPLE_RING_SIZE;
+        }
+
+        uint32_t slot = reader->next & MASK;
+        uint32_t seq = __atomic_load_n(&ring->seq[slot], __ATOMIC_ACQUIRE);
+        if (seq == reader->next + 1) {
+            *sample = ring->slots[slot];
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&ring->seq[slot], __ATOMIC_RELAXED) == seq) {
+                reader->next++;
+                return true;
+            }
+        }
+        // Overwritten while reading: the producer has lapped us, head tells by how much
+        if (head - reader->next == SAMPLE_RING_SIZE) {
+            // Exactly one lap behind and the producer is on this very slot: give it up rather than wait for a
+            // producer that may be preempted by us
+            reader->lost++;
+            reader->next++;
+        }
+    }
+}
+
+size_t sample_ring_aggregate(struct sample_ring_t *ring, struct sample_reader_t *reader, size_t max,
+        struct sample_agg_t *agg) {
+    struct sample_t s;
+    float sum[SAMPLE_CHANNELS];
+    size_t count = 0;
+
+    while ((!max || count < max) && sample_ring_read(ring, reader, &s)) {
+        if (!count) {
+            agg->first_us = s.ts_us;
+            for (int c = 0; c < SAMPLE_CHANNELS; c++)
+                agg->min[c] = agg->max[c] = sum[c] = s.value[c];
+        } else {
+            for (int c = 0; c < SAMPLE_CHANNELS; c++) {
+                agg->min[c] = s.value[c] < agg->min[c] ? s.value[c] : agg->min[c];
+                agg->max[c] = s.value[c] > agg->max[c] ? s.value[c] : agg->max[c];
+                sum[c] += s.value[c];
+            }
+        }
+        agg->last_us = s.ts_us;
+        count++;
+    }
+
+    if (count) {
+        agg->count = count;
+        for (int c = 0; c < SAMPLE_CHANNELS; c++)
+            agg->mean[c] = sum[c] / count;
+    }
+    return count;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file ssd1306_fb.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief SSD1306 framebuffer driver with dirty range tracking
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <ssd1306_fb.h>
+#include <i2c_backend.h>
+
+#define CLEAN_LO    (0xff)
+#define CLEAN_HI    (0x00)
+
+#ifndef MIN
+#define MIN(a, b)   ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b)   ((a) > (b) ? (a) : (b))
+#endif
+
+static const u8 init_cmds[] = {
+    SSD1306_CMD_DISPLAY_OFF,
+    0xd5, 0x80,  // Clock divide ratio, oscillator frequency
+    0xa8, SSD1306_FB_HEIGHT - 1,  // Multiplex ratio
+    0xd3, 0x00,  // Display offset
+    0x40,  // Start line 0
+    0x8d, 0x14,  // Charge pump on
+    SSD1306_CMD_SET_MODE, SSD1306_MODE_HORIZONTAL,  // Column and page wrap inside the window set by flush
+    0xa1,  // Segment remap: column 127 is SEG0
+    0xc8,  // COM scan direction: remapped
+    0xda, 0x12,  // COM pins: alternative configuration
+    SSD1306_CMD_CONTRAST, 0xcf,
+    0xd9, 0xf1,  // Pre-charge period
+    0xdb, 0x40,  // VCOMH deselect level
+    0xa4,  // Display follows RAM
+    0xa6,  // Not inverted
+    SSD1306_CMD_DISPLAY_ON,
+};
+
+static const u8 ctrl_cmd = SSD1306_CTRL_CMD;
+static const u8 ctrl_data = SSD1306_CTRL_DATA;
+
+static bool page_dirty(const struct ssd1306_t *disp, u8 page) {
+    return disp->dirty_lo[page] <= disp->dirty_hi[page];
+}
+
+static size_t max_burst(const struct ssd1306_t *disp) {
+    const struct i2c_backend_t *backend = i2c_get_backend(disp->dev.port);
+    size_t max = backend && backend->max_transfer ? backend->max_transfer(disp->dev.port) : 0;
+    return max ? max : SIZE_MAX;
+}
+
+// One window: set the column and page ranges, then stream the data. With horizontal addressing the controller
+// wraps from hi to lo on the next page by itself, so the framebuffer rows are sent as they are, no copy
+static esp_err_t send_window(struct ssd1306_t *disp, u8 lo, u8 hi, u8 first, u8 last) {
+    const u8 cmds[] = {SSD1306_CMD_COL_RANGE, lo, hi, SSD1306_CMD_PAGE_RANGE, first, last};
+    esp_err_t ret = ssd1306_fb_command(disp, cmds, sizeof(cmds));
+    if (ret != ESP_OK)
+        return ret;
+
+    struct i2c_iovec_t iov[I2C_IOV_MAX];
+    size_t width = hi - lo + 1, max = max_burst(disp), col = 0;
+    u8 page = first;
+    while (page <= last) {
+        size_t n = 1, len = 0;
+        iov[0] = (struct i2c_iovec_t) {.base = &ctrl_data, .len = 1};
+        while (n < I2C_IOV_MAX && page <= last && len < max) {
+            size_t seg = MIN(width - col, max - len);
+            iov[n++] = (struct i2c_iovec_t) {.base = disp->fb[page] + lo + col, .len = seg};
+            len += seg;
+            col += seg;
+            if (col == width) {
+                col = 0;
+                page++;
+            }
+        }
+        ret = i2c_writev(&disp->dev, iov, n);
+        if (ret != ESP_OK)
+            return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_fb_init(struct ssd1306_t *disp, i2c_port_t port, i2c_addr_t addr) {
+    disp->dev = (struct i2c_dev_handle_t) {.port = port, .addr = addr};
+    memset(disp->dirty_lo, CLEAN_LO, sizeof(disp->dirty_lo));  // The instance may be on the stack or re-initialized
+    memset(disp->dirty_hi, CLEAN_HI, sizeof(disp->dirty_hi));
+    esp_err_t ret = ssd1306_fb_command(disp, init_cmds, sizeof(init_cmds));
+    if (ret != ESP_OK)
+        return ret;
+    ssd1306_fb_clear(disp);
+    for (u8 page = 0; page < SSD1306_FB_PAGES; page++)  // GDDRAM content is random at power on
+        ssd1306_fb_mark_dirty(disp, page, 0, SSD1306_FB_WIDTH - 1);
+    return ssd1306_fb_flush(disp);
+}
+
+esp_err_t ssd1306_fb_command(struct ssd1306_t *disp, const u8 *cmds, size_t size) {
+    const struct i2c_iovec_t iov[] = {{.base = &ctrl_cmd, .len = 1}, {.base = cmds, .len = size}};
+    return i2c_writev(&disp->dev, iov, 2);
+}
+
+esp_err_t ssd1306_fb_flush(struct ssd1306_t *disp) {
+    u8 first = 0;
+    while (first < SSD1306_FB_PAGES) {
+        if (!page_dirty(disp, first)) {
+            first++;
+            continue;
+        }
+
+        // Grow the window over the following dirty pages while one window costs less than two
+        u8 lo = disp->dirty_lo[first], hi = disp->dirty_hi[first], last = first;
+        size_t cost = SSD1306_FB_WINDOW_COST + (hi - lo + 1);
+        while (last + 1 < SSD1306_FB_PAGES && page_dirty(disp, last + 1)) {
+            u8 next_lo = disp->dirty_lo[last + 1], next_hi = disp->dirty_hi[last + 1];
+            u8 merged_lo = MIN(lo, next_lo), merged_hi = MAX(hi, next_hi);
+            size_t merged = SSD1306_FB_WINDOW_COST + (size_t) (merged_hi - merged_lo + 1) * (last + 2 - first);
+            size_t apart = cost + SSD1306_FB_WINDOW_COST + (next_hi - next_lo + 1);
+            if (merged > apart)
+                break;
+            lo = merged_lo;
+            hi = merged_hi;
+            cost = merged;
+            last++;
+        }
+
+        esp_err_t ret = send_window(disp, lo, hi, first, last);
+        if (ret != ESP_OK)
+            return ret;
+        for (u8 page = first; page <= last; page++) {
+            disp->dirty_lo[page] = CLEAN_LO;
+            disp->dirty_hi[page] = CLEAN_HI;
+        }
+        first = last + 1;
+    }
+    return ESP_OK;
+}
+
+void ssd1306_fb_mark_dirty(struct ssd1306_t *disp, u8 page, u8 lo, u8 hi) {
+    if (page >= SSD1306_FB_PAGES || lo > hi || lo >= SSD1306_FB_WIDTH)
+        return;
+    hi = MIN(hi, SSD1306_FB_WIDTH - 1);
+    disp->dirty_lo[page] = MIN(disp->dirty_lo[page], lo);
+    disp->dirty_hi[page] = MAX(disp->dirty_hi[page], hi);
+}
+
+void ssd1306_fb_clear(struct ssd1306_t *disp) {
+    static const u8 blank[SSD1306_FB_WIDTH];
+    for (u8 page = 0; page < SSD1306_FB_PAGES; page++)
+        ssd1306_fb_blit(disp, 0, page, blank, SSD1306_FB_WIDTH);
+}
+
+void ssd1306_fb_pixel(struct ssd1306_t *disp, int x, int y, bool on) {
+    if (x < 0 || x >= SSD1306_FB_WIDTH || y < 0 || y >= SSD1306_FB_HEIGHT)
+        return;
+    u8 *col = &disp->fb[y / 8][x];
+    u8 val = on ? *col | (1 << (y % 8)) : *col & ~(1 << (y % 8));
+    if (val != *col) {
+        *col = val;
+        ssd1306_fb_mark_dirty(disp, y / 8, x, x);
+    }
+}
+
+void ssd1306_fb_hline(struct ssd1306_t *disp, int x0, int x1, int y) {
+    for (int x = MAX(x0, 0); x <= MIN(x1, SSD1306_FB_WIDTH - 1); x++)
+        ssd1306_fb_pixel(disp, x, y, true);
+}
+
+void ssd1306_fb_vline(struct ssd1306_t *disp, int x, int y0, int y1) {
+    for (int y = MAX(y0, 0); y <= MIN(y1, SSD1306_FB_HEIGHT - 1); y++)
+        ssd1306_fb_pixel(disp, x, y, true);
+}
+
+void ssd1306_fb_blit(struct ssd1306_t *disp, int x, u8 page, const u8 *cols, size_t n) {
+    if (page >= SSD1306_FB_PAGES)
+        return;
+    for (size_t i = 0; i < n; i++) {
+        int col = x + (int) i;
+        if (col < 0 || col >= SSD1306_FB_WIDTH || disp->fb[page][col] == cols[i])
+            continue;
+        disp->fb[page][col] = cols[i];
+        ssd1306_fb_mark_dirty(disp, page, col, col);
+    }
+}
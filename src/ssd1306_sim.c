@@ -0,0 +1,137 @@
+/**
+ * @file ssd1306_sim.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Simulated SSD1306
+ */
+
+#include <string.h>
+#include <ssd1306_sim.h>
+
+#define MODE_HORIZONTAL (0x00)
+#define MODE_VERTICAL   (0x01)
+#define MODE_PAGE       (0x02)  // Reset value
+
+static u8 args_of(u8 cmd) {
+    switch (cmd) {
+        case SSD1306_CMD_COL_RANGE:
+        case SSD1306_CMD_PAGE_RANGE:
+        case 0xa3:  // Vertical scroll area
+            return 2;
+        case 0x26: case 0x27:  // Horizontal scroll
+            return 6;
+        case 0x29: case 0x2a:  // Vertical and horizontal scroll
+            return 5;
+        case SSD1306_CMD_SET_MODE:
+        case SSD1306_CMD_CONTRAST:
+        case 0x8d: case 0xa8: case 0xd3: case 0xd5: case 0xd9: case 0xda: case 0xdb:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void execute(struct ssd1306_sim_t *model) {
+    const u8 *cmd = model->cmd;
+    model->cmds++;
+    if (cmd[0] == SSD1306_CMD_SET_MODE) {
+        model->mode = cmd[1] & 0x03;
+    } else if (cmd[0] == SSD1306_CMD_COL_RANGE) {
+        model->col = model->col_lo = cmd[1] & 0x7f;
+        model->col_hi = cmd[2] & 0x7f;
+    } else if (cmd[0] == SSD1306_CMD_PAGE_RANGE) {
+        model->page = model->page_lo = cmd[1] & 0x07;
+        model->page_hi = cmd[2] & 0x07;
+    } else if (cmd[0] <= 0x0f) {  // Page addressing: lower column nibble
+        model->col = (model->col & 0xf0) | cmd[0];
+    } else if (cmd[0] <= 0x1f) {  // Page addressing: upper column nibble
+        model->col = ((cmd[0] & 0x07) << 4) | (model->col & 0x0f);
+    } else if (cmd[0] >= 0xb0 && cmd[0] <= 0xb7) {  // Page addressing: page
+        model->page = cmd[0] & 0x07;
+    } else if (cmd[0] == SSD1306_CMD_DISPLAY_ON || cmd[0] == SSD1306_CMD_DISPLAY_OFF) {
+        model->on = cmd[0] == SSD1306_CMD_DISPLAY_ON;
+    }
+}
+
+static void command(struct ssd1306_sim_t *model, u8 byte) {
+    if (!model->cmd_len)
+        model->cmd_need = 1 + args_of(byte);
+    model->cmd[model->cmd_len++] = byte;
+    if (model->cmd_len == model->cmd_need) {
+        execute(model);
+        model->cmd_len = 0;
+    }
+}
+
+static void ram_write(struct ssd1306_sim_t *model, u8 byte) {
+    model->ram[model->page][model->col] = byte;
+    model->data_bytes++;
+    if (model->mode == MODE_HORIZONTAL) {
+        if (model->col != model->col_hi) {
+            model->col++;
+        } else {
+            model->col = model->col_lo;
+            model->page = model->page == model->page_hi ? model->page_lo : model->page + 1;
+        }
+    } else if (model->mode == MODE_VERTICAL) {
+        if (model->page != model->page_hi) {
+            model->page++;
+        } else {
+            model->page = model->page_lo;
+            model->col = model->col == model->col_hi ? model->col_lo : model->col + 1;
+        }
+    } else {
+        model->col = (model->col + 1) % SSD1306_FB_WIDTH;
+    }
+}
+
+static bool sim_start(struct i2c_sim_dev_t *dev, u8 rw) {
+    struct ssd1306_sim_t *model = dev->ctx;
+    (void) rw;
+    model->expect_ctrl = true;
+    return true;
+}
+
+static bool sim_write(struct i2c_sim_dev_t *dev, u8 byte) {
+    struct ssd1306_sim_t *model = dev->ctx;
+    if (model->expect_ctrl) {
+        model->ctrl = byte;
+        model->expect_ctrl = false;
+        return true;
+    }
+    if (model->ctrl & SSD1306_CTRL_DATA)
+        ram_write(model, byte);
+    else
+        command(model, byte);
+    if (model->ctrl & SSD1306_CTRL_CO)  // Single byte, another control byte follows
+        model->expect_ctrl = true;
+    return true;
+}
+
+static u8 sim_read(struct i2c_sim_dev_t *dev, bool ack) {
+    struct ssd1306_sim_t *model = dev->ctx;
+    (void) ack;
+    return model->on ? 0x00 : 0x40;  // Status byte: D6 set when the display is off
+}
+
+static const struct i2c_sim_ops_t ssd1306_ops = {
+    .start = sim_start,
+    .write = sim_write,
+    .read = sim_read,
+    .stop = NULL,
+};
+
+struct i2c_sim_dev_t *ssd1306_sim_init(struct ssd1306_sim_t *model, i2c_addr_t addr) {
+    memset(model, 0, sizeof(*model));
+    model->dev = (struct i2c_sim_dev_t) {.addr = addr, .ops = &ssd1306_ops, .ctx = model};
+    model->mode = MODE_PAGE;
+    model->col_hi = SSD1306_FB_WIDTH - 1;
+    model->page_hi = SSD1306_FB_PAGES - 1;
+    return &model->dev;
+}
+
+bool ssd1306_sim_pixel(const struct ssd1306_sim_t *model, int x, int y) {
+    if (x < 0 || x >= SSD1306_FB_WIDTH || y < 0 || y >= SSD1306_FB_HEIGHT)
+        return false;
+    return model->ram[y / 8][x] & (1 << (y % 8));
+}
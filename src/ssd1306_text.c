@@ -0,0 +1,66 @@
+/**
+ * @file ssd1306_text.c
+ * @author Francesco Mecatti
+ * @date 16 Oct 2026
+ * @brief Incremental text rendering on the SSD1306 framebuffer
+ */
+
+#include <ssd1306_text.h>
+
+// Each bit of a nibble doubled: vertical scaling of half a column
+static const u8 stretch[16] = {
+    0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f,
+    0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff,
+};
+
+static const u8 *glyph(char c) {
+    u8 code = (u8) c;
+    if (code < SSD1306_FONT_FIRST || code > SSD1306_FONT_LAST)
+        code = '?';
+    return ssd1306_font6x8[code - SSD1306_FONT_FIRST];
+}
+
+static void render(struct ssd1306_t *disp, int x, u8 page, char c, u8 scale) {
+    const u8 *cols = glyph(c);
+    if (scale != 2) {
+        ssd1306_fb_blit(disp, x, page, cols, SSD1306_FONT_WIDTH);
+        return;
+    }
+    u8 top[2 * SSD1306_FONT_WIDTH], bottom[2 * SSD1306_FONT_WIDTH];
+    for (int i = 0; i < SSD1306_FONT_WIDTH; i++) {
+        top[2 * i] = top[2 * i + 1] = stretch[cols[i] & 0x0f];
+        bottom[2 * i] = bottom[2 * i + 1] = stretch[cols[i] >> 4];
+    }
+    ssd1306_fb_blit(disp, x, page, top, sizeof(top));
+    ssd1306_fb_blit(disp, x, page + 1, bottom, sizeof(bottom));
+}
+
+void ssd1306_text_init(struct ssd1306_text_t *text, struct ssd1306_t *disp, int x, u8 page, u8 cells, u8 scale) {
+    text->disp = disp;
+    text->x = x;
+    text->page = page;
+    text->cells = cells < SSD1306_TEXT_MAX_CELLS ? cells : SSD1306_TEXT_MAX_CELLS;
+    text->scale = scale == 2 ? 2 : 1;
+    for (u8 i = 0; i < SSD1306_TEXT_MAX_CELLS; i++)
+        text->shown[i] = 0;
+}
+
+size_t ssd1306_text_set(struct ssd1306_text_t *text, const char *str) {
+    size_t rendered = 0;
+    int width = SSD1306_FONT_WIDTH * text->scale;
+    for (u8 i = 0; i < text->cells; i++) {
+        char c = *str ? *str++ : ' ';
+        if (c == text->shown[i])
+            continue;
+        render(text->disp, text->x + i * width, text->page, c, text->scale);
+        text->shown[i] = c;
+        rendered++;
+    }
+    return rendered;
+}
+
+void ssd1306_text_draw(struct ssd1306_t *disp, int x, u8 page, const char *str, u8 scale) {
+    scale = scale == 2 ? 2 : 1;
+    for (; *str; str++, x += SSD1306_FONT_WIDTH * scale)
+        render(disp, x, page, *str, scale);
+}